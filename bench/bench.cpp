@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "file_ops.h"
+#include "generator.h"
+#include "input.h"
+#include "table.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+using bench_clock = std::chrono::steady_clock;
+
+//!
+//! \brief The BenchCase struct Game to be measured
+//!
+struct BenchCase
+{
+    std::string name;   //!< name of the game
+    input_data_t data;  //!< input data
+};
+
+//!
+//! \brief The BenchResult struct Best time of every phase
+//!
+struct BenchResult
+{
+    double parse_us;        //!< InputData parsing
+    double construct_us;    //!< GameTable construction
+    double build_graph_us;  //!< BuildMoveGraph
+    double roll_ns;         //!< one RollAllBalls call
+    double solve_us;        //!< full CalculateMoves
+    size_t solutions;       //!< number of best moves sequences
+    size_t moves;           //!< length of best moves sequences
+    size_t generated;       //!< number of generated states
+};
+
+//!
+//! \brief The BenchTable class Gives access to internal phases of the search
+//!
+class BenchTable : public GameTable
+{
+public:
+    BenchTable (const InputData & in) : GameTable(in) {}
+
+    void RebuildMoveGraph ()
+    {
+        BuildMoveGraph();
+    }
+
+    //!
+    //! \brief RollFromStart roll balls from initial position to all
+    //! directions
+    //! \param iterations number of rolls to every direction
+    //!
+    void RollFromStart (size_t iterations)
+    {
+        positions_t balls;
+        positions_t holes;
+        for (auto & ball : balls_)
+        {
+            balls.insert(std::make_pair(ball.first, ball.second.GetId()));
+        }
+        for (auto & hole : board_->GetHoles())
+        {
+            holes.insert(std::make_pair(hole.second, hole.first));
+        }
+
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                positions_t new_position;
+                positions_t removed;
+                RollAllBalls(to, balls, holes, new_position, removed);
+            }
+        }
+    }
+};
+
+//!
+//! \brief GenerateCase create random game
+//! \param size board size
+//! \param balls number of balls
+//! \param wall_percent probability of every wall, percents
+//! \param seed random seed
+//! \return generated game
+//!
+BenchCase GenerateCase (coordinate_t size, coordinate_t balls,
+                        unsigned wall_percent, std::uint64_t seed)
+{
+    GeneratorOptions options;
+    options.table_size = size;
+    options.balls_count = balls;
+    options.wall_percent = wall_percent;
+
+    BenchCase bench_case;
+    std::ostringstream name;
+    name << "gen_n" << size << "_k" << balls << "_w" << wall_percent
+         << "_s" << seed;
+    bench_case.name = name.str();
+    bench_case.data = GeneratePuzzle(options, seed);
+
+    return bench_case;
+}
+
+//!
+//! \brief MicrosecondsSince gives time passed from the moment
+//! \param start the moment
+//! \return microseconds
+//!
+double MicrosecondsSince (bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+}
+
+//!
+//! \brief RunCase measure all phases for the game, best of %repeat runs
+//! \param bench_case game
+//! \param repeat number of runs
+//! \param max_moves moves limit for solver
+//! \param tilt_cache number of tilt cache slots
+//! \return measured times
+//!
+BenchResult RunCase (const BenchCase & bench_case, size_t repeat, size_t max_moves,
+                     size_t tilt_cache)
+{
+    const size_t roll_iterations = 100;
+    BenchResult result = {1e300, 1e300, 1e300, 1e300, 1e300, 0, 0, 0};
+
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        auto start = bench_clock::now();
+        InputData data (bench_case.data);
+        result.parse_us = std::min(result.parse_us, MicrosecondsSince(start));
+
+        start = bench_clock::now();
+        BenchTable table (data);
+        result.construct_us = std::min(result.construct_us, MicrosecondsSince(start));
+
+        start = bench_clock::now();
+        table.RebuildMoveGraph();
+        result.build_graph_us = std::min(result.build_graph_us, MicrosecondsSince(start));
+
+        start = bench_clock::now();
+        table.RollFromStart(roll_iterations);
+        result.roll_ns = std::min(result.roll_ns,
+                                  MicrosecondsSince(start) * 1000 / roll_iterations / 4);
+
+        BenchTable solver (data);
+        solver.SetMaxMoves(max_moves);
+        solver.SetTiltCacheSize(tilt_cache);
+        start = bench_clock::now();
+        solver.CalculateMoves();
+        result.solve_us = std::min(result.solve_us, MicrosecondsSince(start));
+
+        auto moves = solver.GetMoves();
+        result.solutions = moves.size();
+        result.moves = moves.empty() ? 0 : moves.front().size();
+        result.generated = solver.GetStats().GetGenerated();
+    }
+    return result;
+}
+
+void Usage (std::string program_name)
+{
+    size_t pos = program_name.find_last_of('/');
+    if ((pos != std::string::npos) && (pos < program_name.length()))
+    {
+        program_name = program_name.substr(pos+1);
+    }
+
+    std::cout << "\n"
+           "Usage: " << program_name << " OPTIONS [FILES]\n"
+           "\n"
+           "Measures every phase of solving for bundled samples, generated\n"
+           "games and FILES. Best time of all runs is reported.\n"
+           "\n"
+           "OPTIONS:\n"
+           "  -j, --json        Print results as JSON, default is CSV\n"
+           "  -r, --repeat      Number of runs for every game, default 3\n"
+           "  -m, --max-moves   Moves limit for solver, default 10\n"
+           "  -t, --tilt-cache  Number of tilt cache slots, 0 disables it\n"
+           "  -q, --quick       Skip generated games\n"
+           "  -h, --help        Display this help and exit\n"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    static struct option longopts[] =
+    {
+        {"json",       no_argument,       NULL, 'j'},
+        {"repeat",     required_argument, NULL, 'r'},
+        {"max-moves",  required_argument, NULL, 'm'},
+        {"tilt-cache", required_argument, NULL, 't'},
+        {"quick",      no_argument,       NULL, 'q'},
+        {"help",       no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    bool json = false;
+    bool quick = false;
+    size_t repeat = 3;
+    size_t max_moves = 10;
+    size_t tilt_cache = TiltCache::kDefaultSize;
+
+    while (1)
+    {
+        int long_index = 0;
+        int opt = getopt_long(argc, argv, "jr:m:t:qh", longopts, &long_index);
+
+        if (opt == -1)
+            break;
+
+        switch (opt) {
+        case 'j':
+            json = true;
+            break;
+        case 'r':
+            repeat = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'm':
+            max_moves = std::strtoul(optarg, NULL, 10);
+            break;
+        case 't':
+            tilt_cache = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'q':
+            quick = true;
+            break;
+        case 'h':
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (repeat == 0)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    std::vector <std::string> files (argv + optind, argv + argc);
+    for (unsigned i = 1; ; ++i)
+    {
+        std::ostringstream name;
+        name << SAMPLES_DIR << "/sample_" << i << ".txt";
+        if (!std::ifstream(name.str()))
+        {
+            break;
+        }
+        files.push_back(name.str());
+    }
+
+    std::vector <BenchCase> cases;
+    for (auto & file : files)
+    {
+        size_t pos = file.find_last_of('/');
+        cases.push_back({file.substr((pos == std::string::npos) ? 0 : pos + 1),
+                         FileInput(file).GetData()});
+    }
+
+    if (!quick)
+    {
+        // Same corpus every run: sizes, balls and wall density are swept,
+        // several seeds for every combination
+        for (coordinate_t size : {4, 6, 8, 12, 16, 24})
+        {
+            for (coordinate_t balls : {1, 2, 3})
+            {
+                for (unsigned walls : {0, 10, 25})
+                {
+                    for (std::uint64_t seed = 1; seed <= 2; ++seed)
+                    {
+                        cases.push_back(GenerateCase(size, balls, walls, seed));
+                    }
+                }
+            }
+        }
+    }
+
+    if (json)
+    {
+        std::cout << "[\n";
+    }
+    else
+    {
+        std::cout << "name,size,balls,walls,parse_us,construct_us,build_graph_us,"
+                     "roll_ns,solve_us,solutions,moves,generated\n";
+    }
+
+    for (size_t i = 0; i < cases.size(); ++i)
+    {
+        const BenchCase & c = cases[i];
+        InputData data (c.data);
+        if (data.GetDataStatus() != InputData::Status::Ok)
+        {
+            std::cerr << c.name << ": " << data.GetErrorString() << "\n";
+            continue;
+        }
+
+        BenchResult r = RunCase(c, repeat, max_moves, tilt_cache);
+
+        if (json)
+        {
+            std::cout << "  {\"name\": \"" << c.name << "\""
+                      << ", \"size\": " << data.GetTableSize()
+                      << ", \"balls\": " << data.GetBallCount()
+                      << ", \"walls\": " << data.GetWallCount()
+                      << ", \"parse_us\": " << r.parse_us
+                      << ", \"construct_us\": " << r.construct_us
+                      << ", \"build_graph_us\": " << r.build_graph_us
+                      << ", \"roll_ns\": " << r.roll_ns
+                      << ", \"solve_us\": " << r.solve_us
+                      << ", \"solutions\": " << r.solutions
+                      << ", \"moves\": " << r.moves
+                      << ", \"generated\": " << r.generated
+                      << "}" << ((i + 1 < cases.size()) ? "," : "") << "\n";
+        }
+        else
+        {
+            std::cout << c.name << "," << data.GetTableSize()
+                      << "," << data.GetBallCount()
+                      << "," << data.GetWallCount()
+                      << "," << r.parse_us
+                      << "," << r.construct_us
+                      << "," << r.build_graph_us
+                      << "," << r.roll_ns
+                      << "," << r.solve_us
+                      << "," << r.solutions
+                      << "," << r.moves
+                      << "," << r.generated << "\n";
+        }
+        std::cout.flush();
+    }
+
+    if (json)
+    {
+        std::cout << "]\n";
+    }
+
+    return 0;
+}
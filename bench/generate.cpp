@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <getopt.h>
+
+#include "generator.h"
+
+namespace
+{
+
+//!
+//! \brief WritePuzzle print game as single line
+//! \param os output stream
+//! \param puzzle game
+//!
+void WritePuzzle (std::ostream & os, const input_data_t & puzzle)
+{
+    for (size_t i = 0; i < puzzle.size(); ++i)
+    {
+        os << (i ? " " : "") << puzzle[i];
+    }
+    os << "\n";
+}
+
+void Usage (std::string program_name)
+{
+    size_t pos = program_name.find_last_of('/');
+    if ((pos != std::string::npos) && (pos < program_name.length()))
+    {
+        program_name = program_name.substr(pos+1);
+    }
+
+    std::cout << "\n"
+           "Usage: " << program_name << " OPTIONS\n"
+           "\n"
+           "Generates random games in the format accepted by table_game.\n"
+           "Every game is printed as single line, the same options always\n"
+           "give the same games.\n"
+           "\n"
+           "OPTIONS:\n"
+           "  -n, --size        Size of the board, default 4\n"
+           "  -k, --balls       Number of balls, default 2\n"
+           "  -w, --walls       Probability of every wall, percents, default 10\n"
+           "  -s, --seed        Random seed, default 1\n"
+           "  -c, --count       Number of games, default 1\n"
+           "  -j, --jobs        Number of threads, default is number of CPUs\n"
+           "  -a, --min-moves   Keep only games with longer or equal best solution\n"
+           "  -b, --max-moves   Keep only games with shorter or equal best solution\n"
+           "  -o, --output      Write every game to separate file OUTPUT_<index>.txt\n"
+           "  -h, --help        Display this help and exit\n"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    static struct option longopts[] =
+    {
+        {"size",      required_argument, NULL, 'n'},
+        {"balls",     required_argument, NULL, 'k'},
+        {"walls",     required_argument, NULL, 'w'},
+        {"seed",      required_argument, NULL, 's'},
+        {"count",     required_argument, NULL, 'c'},
+        {"jobs",      required_argument, NULL, 'j'},
+        {"min-moves", required_argument, NULL, 'a'},
+        {"max-moves", required_argument, NULL, 'b'},
+        {"output",    required_argument, NULL, 'o'},
+        {"help",      no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    GeneratorOptions options;
+    std::uint64_t count = 1;
+    unsigned threads = 0;
+    std::string output;
+
+    while (1)
+    {
+        int long_index = 0;
+        int opt = getopt_long(argc, argv, "n:k:w:s:c:j:a:b:o:h", longopts,
+                              &long_index);
+
+        if (opt == -1)
+            break;
+
+        switch (opt) {
+        case 'n':
+            options.table_size = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'k':
+            options.balls_count = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'w':
+            options.wall_percent = std::strtoul(optarg, NULL, 10);
+            break;
+        case 's':
+            options.seed = std::strtoull(optarg, NULL, 10);
+            break;
+        case 'c':
+            count = std::strtoull(optarg, NULL, 10);
+            break;
+        case 'j':
+            threads = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'a':
+            options.min_moves = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'b':
+            options.max_moves = std::strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'h':
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((options.min_moves != 0) && (options.max_moves == 0))
+    {
+        std::cerr << "Error: --min-moves requires --max-moves" << std::endl;
+        return 1;
+    }
+    if (!IsValid(options))
+    {
+        std::cerr << "Error: invalid generator options" << std::endl;
+        return 1;
+    }
+
+    bool failed = false;
+    size_t generated = GeneratePuzzles(options, count, threads,
+        [&] (std::uint64_t index, const input_data_t & puzzle)
+        {
+            if (output.empty())
+            {
+                WritePuzzle(std::cout, puzzle);
+                return;
+            }
+
+            std::ostringstream name;
+            name << output << "_" << index << ".txt";
+            std::ofstream file (name.str());
+            WritePuzzle(file, puzzle);
+            if (!file)
+            {
+                failed = true;
+            }
+        });
+    std::cout.flush();
+
+    if (failed)
+    {
+        std::cerr << "Error: cannot write games to " << output << std::endl;
+        return 1;
+    }
+    if (generated < count)
+    {
+        std::cerr << "Warning: " << count - generated
+                  << " games don't match moves filter" << std::endl;
+    }
+
+    return 0;
+}
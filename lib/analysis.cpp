@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "analysis.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "tg_utils.h"
+
+std::ostream &
+operator<< (std::ostream & os, Unsolvability reason)
+{
+    switch (reason)
+    {
+    case Unsolvability::None:
+        os << "none";
+        break;
+    case Unsolvability::FrozenBall:
+        os << "frozen_ball";
+        break;
+    case Unsolvability::SeparatedHole:
+        os << "separated_hole";
+        break;
+    case Unsolvability::UnreachableHole:
+        os << "unreachable_hole";
+        break;
+    case Unsolvability::CyclicOrder:
+        os << "cyclic_order";
+        break;
+    }
+    return os;
+}
+
+std::vector<ball_id_t>
+FindFrozenBalls(const move_graph_t &graph,
+                const std::map<coordinates_t, Ball> &balls)
+{
+    // Balls blocking each other are frozen together, so start from all the
+    // balls and release the ones which have some way out, until nothing
+    // changes
+    std::map <coordinates_t, bool> frozen;
+    for (auto & ball : balls)
+    {
+        frozen[ball.first] = true;
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto & ball : frozen)
+        {
+            if (!ball.second)
+            {
+                continue;
+            }
+
+            const GraphItem & item = graph.at(ball.first);
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                if (item.GetNeigbour(to) == ball.first)
+                {
+                    // wall
+                    continue;
+                }
+                auto next = frozen.find(GetNeighbourCell(ball.first, to));
+                if ((next == frozen.end()) || !next->second)
+                {
+                    ball.second = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector <ball_id_t> ids;
+    for (auto & ball : balls)
+    {
+        if (frozen[ball.first])
+        {
+            ids.push_back(ball.second.GetId());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+ball_id_t
+FindSeparatedBall(const move_graph_t &graph,
+                  const std::map<coordinates_t, Ball> &balls,
+                  const std::map<ball_id_t, coordinates_t> &holes)
+{
+    // Ball moves at least to the next cell if there is no wall between
+    // them. So every ball stays in the part of the board, which is
+    // reachable from its initial cell through cells without walls
+    std::map <coordinates_t, size_t> parts;
+    size_t parts_count = 0;
+    for (auto & item : graph)
+    {
+        if (parts.count(item.first) != 0)
+        {
+            continue;
+        }
+        ++parts_count;
+        parts[item.first] = parts_count;
+        std::deque <coordinates_t> cells {item.first};
+        while (!cells.empty())
+        {
+            coordinates_t cell = cells.front();
+            cells.pop_front();
+            const GraphItem & cell_item = graph.at(cell);
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                if (cell_item.GetNeigbour(to) == cell)
+                {
+                    // wall
+                    continue;
+                }
+                coordinates_t next = GetNeighbourCell(cell, to);
+                if (parts.insert(std::make_pair(next, parts_count)).second)
+                {
+                    cells.push_back(next);
+                }
+            }
+        }
+    }
+
+    for (auto & ball : balls)
+    {
+        if (parts.at(ball.first) != parts.at(holes.at(ball.second.GetId())))
+        {
+            return ball.second.GetId();
+        }
+    }
+    return INVALID_ID;
+}
+
+HoleOrder::HoleOrder(const RestCells &rest,
+                     const move_graph_t &graph,
+                     const std::map<coordinates_t, Ball> &balls,
+                     const std::map<ball_id_t, coordinates_t> &holes)
+    : balls_count_(static_cast<ball_id_t>(holes.size()))
+    , cells_count_(rest.GetCount())
+    , starts_(holes.size() + 1, RestCells::kInvalidIndex)
+    , before_(holes.size() + 1, std::vector <bool> (holes.size() + 1, false))
+    , dependencies_count_(0)
+    , cyclic_(false)
+    , unreachable_(INVALID_ID)
+    , alive_(holes.size() + 1, std::vector <bool> (rest.GetCount(), false))
+{
+    for (auto & ball : balls)
+    {
+        starts_[ball.second.GetId()] = rest.GetIndex(ball.first);
+    }
+    std::map <coordinates_t, ball_id_t> hole_at;
+    for (auto & hole : holes)
+    {
+        hole_at[hole.second] = hole.first;
+    }
+
+    // ball rolls to the stop cell of the move graph, unless it is stopped
+    // by other ball or falls to some hole
+    ways_.reserve(cells_count_ * 4 + 1);
+    for (std::uint32_t cell = 0; cell < cells_count_; ++cell)
+    {
+        const coordinates_t & from = rest.GetCell(cell);
+        const GraphItem & item = graph.at(from);
+        for (auto to : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+        {
+            ways_.push_back(hops_.size());
+            const coordinates_t & stop = item.GetNeigbour(to);
+            for (coordinates_t hop = from; hop != stop; )
+            {
+                hop = GetNeighbourCell(hop, to);
+                auto hole = hole_at.find(hop);
+                hops_.push_back({rest.GetIndex(hop),
+                                 (hole != hole_at.end()) ? hole->second
+                                                         : INVALID_ID});
+            }
+        }
+    }
+    ways_.push_back(hops_.size());
+
+    // ball cannot reach its hole even if all other holes are closed
+    std::vector <bool> open (balls_count_ + 1, false);
+    for (ball_id_t ball = 1; ball <= balls_count_; ++ball)
+    {
+        if (!FindAlive(ball, open, false)[starts_[ball]])
+        {
+            unreachable_ = ball;
+            return;
+        }
+    }
+
+    // Ball B drops before ball A if A cannot reach its hole while hole B
+    // is open. Both balls may drop by the same move, then hole B is
+    // closed before A crosses it, so the last move of A may cross hole B
+    for (ball_id_t ball = 1; ball <= balls_count_; ++ball)
+    {
+        for (ball_id_t other = 1; other <= balls_count_; ++other)
+        {
+            if (other == ball)
+            {
+                continue;
+            }
+            open[other] = true;
+            if (!FindAlive(ball, open, true)[starts_[ball]])
+            {
+                before_[other][ball] = true;
+                ++dependencies_count_;
+            }
+            open[other] = false;
+        }
+    }
+
+    for (ball_id_t k = 1; k <= balls_count_; ++k)
+    {
+        for (ball_id_t i = 1; i <= balls_count_; ++i)
+        {
+            if (!before_[i][k])
+            {
+                continue;
+            }
+            for (ball_id_t j = 1; j <= balls_count_; ++j)
+            {
+                if (before_[k][j])
+                {
+                    before_[i][j] = true;
+                }
+            }
+        }
+    }
+    for (ball_id_t ball = 1; ball <= balls_count_; ++ball)
+    {
+        cyclic_ = cyclic_ || before_[ball][ball];
+    }
+    if (cyclic_)
+    {
+        // every cell is dead
+        return;
+    }
+
+    // holes of balls dropping later are open all the way of the ball
+    for (ball_id_t ball = 1; ball <= balls_count_; ++ball)
+    {
+        alive_[ball] = FindAlive(ball, before_[ball], false);
+    }
+}
+
+bool HoleOrder::IsCyclic() const
+{
+    return cyclic_;
+}
+
+bool HoleOrder::IsSolvable() const
+{
+    if (cyclic_ || (unreachable_ != INVALID_ID))
+    {
+        return false;
+    }
+    for (ball_id_t ball = 1; ball <= balls_count_; ++ball)
+    {
+        if (!alive_[ball][starts_[ball]])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Unsolvability HoleOrder::GetUnsolvability() const
+{
+    if (cyclic_)
+    {
+        return Unsolvability::CyclicOrder;
+    }
+    return IsSolvable() ? Unsolvability::None : Unsolvability::UnreachableHole;
+}
+
+bool HoleOrder::MustDropBefore(ball_id_t first, ball_id_t second) const
+{
+    return before_[first][second];
+}
+
+size_t HoleOrder::GetDependenciesCount() const
+{
+    return dependencies_count_;
+}
+
+std::vector<bool> HoleOrder::FindAlive(ball_id_t ball,
+                                       const std::vector<bool> &open,
+                                       bool last_move) const
+{
+    // cells, from where ball can move to the cell
+    std::vector <std::vector <std::uint32_t> > sources (cells_count_);
+    std::vector <bool> alive (cells_count_, false);
+    std::vector <std::uint32_t> queue;
+
+    for (std::uint32_t cell = 0; cell < cells_count_; ++cell)
+    {
+        for (size_t way = cell * 4; way < cell * 4 + 4; ++way)
+        {
+            bool crossed = false;
+            for (size_t i = ways_[way]; i < ways_[way + 1]; ++i)
+            {
+                const Hop & hop = hops_[i];
+                if (hop.hole == ball)
+                {
+                    if ((!crossed || last_move) && !alive[cell])
+                    {
+                        alive[cell] = true;
+                        queue.push_back(cell);
+                    }
+                    break;
+                }
+                if ((hop.hole != INVALID_ID) && open[hop.hole])
+                {
+                    if (!last_move)
+                    {
+                        break;
+                    }
+                    // only the last move goes further
+                    crossed = true;
+                    continue;
+                }
+                if (!crossed && (hop.cell != RestCells::kInvalidIndex))
+                {
+                    sources[hop.cell].push_back(cell);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        for (auto cell : sources[queue[i]])
+        {
+            if (!alive[cell])
+            {
+                alive[cell] = true;
+                queue.push_back(cell);
+            }
+        }
+    }
+    return alive;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_ANALYSIS_H
+#define TG_ANALYSIS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "ball.h"
+#include "move_graph.h"
+#include "rest_cells.h"
+#include "tg_types.h"
+
+//! \file
+//! Static analysis of the game done before search.
+
+//!
+//! \brief The Unsolvability enum Reason why game cannot be won, found
+//! without search
+//!
+enum class Unsolvability
+{
+    None,               //!< No reason found, game may be solvable
+    FrozenBall,         //!< Some ball can never move
+    SeparatedHole,      //!< Walls separate some ball from its hole
+    UnreachableHole,    //!< Some ball cannot reach its hole by any moves
+    CyclicOrder         //!< Holes cannot be closed in any order
+};
+
+std::ostream &
+operator<< (std::ostream & os, Unsolvability reason);
+
+//!
+//! \brief FindFrozenBalls find balls which can never move. Ball is frozen if
+//! in every direction it is stopped by the wall or by other frozen ball.
+//! Frozen ball never gets to its hole, since balls don't start in holes
+//! \param graph move graph of the board
+//! \param balls initial positions of balls
+//! \return ids of frozen balls in ascending order
+//!
+std::vector <ball_id_t>
+FindFrozenBalls (const move_graph_t & graph,
+                 const std::map <coordinates_t, Ball> & balls);
+
+//!
+//! \brief FindSeparatedBall find ball, which is separated from its hole
+//! by walls: ball never leaves the part of the board enclosed by walls
+//! \param graph move graph of the board
+//! \param balls initial positions of balls
+//! \param holes positions of holes
+//! \return ball id, INVALID_ID if every ball shares its part of the board
+//! with its hole
+//!
+ball_id_t
+FindSeparatedBall (const move_graph_t & graph,
+                   const std::map <coordinates_t, Ball> & balls,
+                   const std::map <ball_id_t, coordinates_t> & holes);
+
+//!
+//! \brief The HoleOrder class Order in which holes must be closed.
+//!
+//! Ball crossing open hole of other ball loses the game. So if every way of
+//! ball A to its hole crosses hole of ball B, ball B must drop first. Such
+//! dependencies are found from the move graph: ball is moved alone, it can
+//! stop at any rest cell on its way, since other balls may block it there.
+//! This is wider than real moves, so every found dependency holds for any
+//! solution of the game. Cyclic dependencies mean that game cannot be won.
+//!
+//! Balls, which must drop later, keep their holes open all the way of the
+//! ball. Rest cells, from where the ball cannot reach its hole through them,
+//! are dead: states with a ball in its dead cell never lead to the win.
+//!
+class HoleOrder
+{
+public:
+    //!
+    //! \brief HoleOrder Find dependencies between holes and dead cells
+    //! \param rest rest cells of the board
+    //! \param graph move graph of the board
+    //! \param balls initial positions of balls
+    //! \param holes positions of holes
+    //!
+    HoleOrder (const RestCells & rest,
+               const move_graph_t & graph,
+               const std::map <coordinates_t, Ball> & balls,
+               const std::map <ball_id_t, coordinates_t> & holes);
+
+    //!
+    //! \brief IsCyclic check if holes cannot be closed in any order
+    //! \return true if dependencies are cyclic
+    //!
+    bool IsCyclic () const;
+
+    //!
+    //! \brief IsSolvable check if the game may be won. The check is not
+    //! complete: game still may be unsolvable
+    //! \return false if dependencies are cyclic or some ball cannot reach
+    //! its hole from its initial position
+    //!
+    bool IsSolvable () const;
+
+    //!
+    //! \brief GetUnsolvability gives the reason why game cannot be won
+    //! \return %Unsolvability::CyclicOrder, %Unsolvability::UnreachableHole
+    //! or %Unsolvability::None if the game may be solvable
+    //!
+    Unsolvability GetUnsolvability () const;
+
+    //!
+    //! \brief MustDropBefore check if one ball must drop to its hole by
+    //! earlier move than other one, directly or through other balls
+    //! \param first ball id
+    //! \param second other ball id
+    //! \return true if %first ball drops before %second
+    //!
+    bool MustDropBefore (ball_id_t first, ball_id_t second) const;
+
+    //!
+    //! \brief GetDependenciesCount number of direct dependencies between balls
+    //! \return dependencies count
+    //!
+    size_t GetDependenciesCount () const;
+
+    //!
+    //! \brief IsDead check if ball can never reach its hole from the cell
+    //! \param ball ball id
+    //! \param cell rest cell index
+    //! \return true if cell is dead for the ball
+    //!
+    bool IsDead (ball_id_t ball, std::uint32_t cell) const
+    {
+        return !alive_[ball][cell];
+    }
+
+private:
+    //! \brief Hop cell on the way of the ball
+    struct Hop
+    {
+        std::uint32_t cell; //!< rest cell index, invalid if ball cannot stop
+        ball_id_t hole;     //!< id of hole in the cell, INVALID_ID if none
+    };
+
+    //! \brief balls_count_ number of balls
+    ball_id_t balls_count_;
+
+    //! \brief cells_count_ number of rest cells
+    std::uint32_t cells_count_;
+
+    //! \brief starts_ initial rest cell of every ball, by ball id
+    std::vector <std::uint32_t> starts_;
+
+    //! \brief hops_ ways from every rest cell in every direction
+    std::vector <Hop> hops_;
+
+    //! \brief ways_ first hop of every way in %hops_, the way of cell c
+    //! in direction d ends where the next way begins
+    std::vector <size_t> ways_;
+
+    //! \brief before_ before_[a][b] is true if ball a drops before ball b,
+    //! transitive closure of dependencies
+    std::vector <std::vector <bool> > before_;
+
+    //! \brief dependencies_count_ number of direct dependencies
+    size_t dependencies_count_;
+
+    //! \brief cyclic_ true if dependencies are cyclic
+    bool cyclic_;
+
+    //! \brief unreachable_ id of ball, which cannot reach its hole in any
+    //! way, INVALID_ID if every ball can. Dependencies are not searched then
+    ball_id_t unreachable_;
+
+    //! \brief alive_ cells where ball can reach its hole from, by ball id
+    std::vector <std::vector <bool> > alive_;
+
+    //!
+    //! \brief FindAlive find cells from where ball can reach its hole
+    //! \param ball ball id
+    //! \param open holes which are open all the way of the ball, by hole id
+    //! \param last_move true if open holes may be closed by other balls
+    //! right at the last move of the ball
+    //! \return alive rest cells
+    //!
+    std::vector <bool> FindAlive (ball_id_t ball, const std::vector <bool> & open,
+                                  bool last_move) const;
+};
+
+#endif // TG_ANALYSIS_H
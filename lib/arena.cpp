@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arena.h"
+
+#include <new>
+
+namespace
+{
+
+//! \brief kAlignment alignment of all chunks
+const size_t kAlignment = 16;
+
+//! \brief kSizeClasses number of chunk sizes kept in free lists. Bigger
+//! chunks are not reused until arena is released
+const size_t kSizeClasses = 32;
+
+//!
+//! \brief SizeClass Gives size class of the chunk
+//! \param size chunk size
+//! \return size class, chunks of the same class have equal real size
+//!
+inline size_t SizeClass (size_t size)
+{
+    return (size + kAlignment - 1) / kAlignment;
+}
+
+} // namespace
+
+thread_local Arena * Arena::current_ = nullptr;
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size)
+    , position_(nullptr)
+    , end_(nullptr)
+    , free_lists_(kSizeClasses + 1, nullptr)
+    , bytes_reserved_(0)
+    , peak_bytes_reserved_(0)
+    , bytes_in_use_(0)
+    , peak_bytes_in_use_(0)
+{
+
+}
+
+Arena::~Arena()
+{
+    Release();
+}
+
+void *Arena::Allocate(size_t size)
+{
+    size_t size_class = SizeClass(size);
+    size_t real_size = size_class * kAlignment;
+
+    bytes_in_use_ += real_size;
+    if (bytes_in_use_ > peak_bytes_in_use_)
+    {
+        peak_bytes_in_use_ = bytes_in_use_;
+    }
+
+    if ((size_class <= kSizeClasses) && (free_lists_[size_class] != nullptr))
+    {
+        void * chunk = free_lists_[size_class];
+        free_lists_[size_class] = *static_cast<void **>(chunk);
+        return chunk;
+    }
+
+    if (static_cast<size_t>(end_ - position_) < real_size)
+    {
+        size_t new_block_size = (real_size > block_size_) ? real_size
+                                                          : block_size_;
+        char * block = static_cast<char *>(::operator new(new_block_size));
+        blocks_.push_back(block);
+        position_ = block;
+        end_ = block + new_block_size;
+
+        bytes_reserved_ += new_block_size;
+        if (bytes_reserved_ > peak_bytes_reserved_)
+        {
+            peak_bytes_reserved_ = bytes_reserved_;
+        }
+    }
+
+    void * chunk = position_;
+    position_ += real_size;
+    return chunk;
+}
+
+void Arena::Deallocate(void *p, size_t size)
+{
+    size_t size_class = SizeClass(size);
+    bytes_in_use_ -= size_class * kAlignment;
+
+    if (size_class <= kSizeClasses)
+    {
+        *static_cast<void **>(p) = free_lists_[size_class];
+        free_lists_[size_class] = p;
+    }
+}
+
+void Arena::Release()
+{
+    for (auto block : blocks_)
+    {
+        ::operator delete(block);
+    }
+    blocks_.clear();
+    position_ = nullptr;
+    end_ = nullptr;
+    free_lists_.assign(kSizeClasses + 1, nullptr);
+    bytes_reserved_ = 0;
+    bytes_in_use_ = 0;
+}
+
+size_t Arena::GetBytesReserved() const
+{
+    return bytes_reserved_;
+}
+
+size_t Arena::GetPeakBytesReserved() const
+{
+    return peak_bytes_reserved_;
+}
+
+size_t Arena::GetBytesInUse() const
+{
+    return bytes_in_use_;
+}
+
+size_t Arena::GetPeakBytesInUse() const
+{
+    return peak_bytes_in_use_;
+}
+
+Arena *Arena::GetCurrent()
+{
+    return current_;
+}
+
+ArenaScope::ArenaScope(Arena &arena)
+    : previous_(Arena::current_)
+{
+    Arena::current_ = &arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+    Arena::current_ = previous_;
+}
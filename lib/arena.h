@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_ARENA_H
+#define TG_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+//!
+//! \brief The Arena class Memory pool for short living objects of one search.
+//!
+//! Memory is taken from big blocks. Freed chunks are kept in per-size free
+//! lists and reused by next allocations of the same size, but blocks are
+//! returned to the system only all at once, when arena is released or
+//! destroyed.
+//!
+class Arena
+{
+public:
+    //! \brief kDefaultBlockSize size of memory blocks requested from system
+    static const size_t kDefaultBlockSize = 1024 * 1024;
+
+    //!
+    //! \brief Arena Create empty arena. No memory is reserved until first
+    //! allocation
+    //! \param block_size size of memory blocks requested from system
+    //!
+    explicit Arena (size_t block_size = kDefaultBlockSize);
+    ~Arena ();
+
+    Arena (const Arena &) = delete;
+    Arena & operator= (const Arena &) = delete;
+
+    //!
+    //! \brief Allocate Allocate memory chunk aligned as any fundamental type
+    //! \param size requested size
+    //! \return pointer to allocated memory
+    //!
+    void * Allocate (size_t size);
+
+    //!
+    //! \brief Deallocate Return chunk to arena, it will be reused by next
+    //! allocations of the same size
+    //! \param p chunk allocated by %Allocate()
+    //! \param size size of the chunk
+    //!
+    void Deallocate (void * p, size_t size);
+
+    //!
+    //! \brief Release Return all the memory to the system. All chunks
+    //! allocated from arena become invalid
+    //!
+    void Release ();
+
+    //!
+    //! \brief GetBytesReserved Gives size of memory blocks held by arena
+    //! \return size in bytes
+    //!
+    size_t GetBytesReserved () const;
+
+    //!
+    //! \brief GetPeakBytesReserved Gives maximum size of memory blocks
+    //! held by arena during its lifetime
+    //! \return size in bytes
+    //!
+    size_t GetPeakBytesReserved () const;
+
+    //!
+    //! \brief GetBytesInUse Gives size of allocated and not freed chunks
+    //! \return size in bytes
+    //!
+    size_t GetBytesInUse () const;
+
+    //!
+    //! \brief GetPeakBytesInUse Gives maximum size of chunks in use during
+    //! arena lifetime
+    //! \return size in bytes
+    //!
+    size_t GetPeakBytesInUse () const;
+
+    //!
+    //! \brief GetCurrent Gives arena used by current thread
+    //! \see %ArenaScope
+    //! \return current arena, nullptr if thread doesn't use any
+    //!
+    static Arena * GetCurrent ();
+
+private:
+    friend class ArenaScope;
+
+    //! \brief current_ arena used by current thread
+    static thread_local Arena * current_;
+
+    //! \brief block_size_ size of memory blocks requested from system
+    size_t block_size_;
+
+    //! \brief blocks_ memory blocks owned by arena
+    std::vector <char *> blocks_;
+
+    //! \brief position_ start of free space in the last block
+    char * position_;
+
+    //! \brief end_ end of the last block
+    char * end_;
+
+    //! \brief free_lists_ heads of free chunks lists, one list per size class
+    std::vector <void *> free_lists_;
+
+    //! \brief bytes_reserved_ size of all blocks
+    size_t bytes_reserved_;
+
+    //! \brief peak_bytes_reserved_ maximum value of %bytes_reserved_
+    size_t peak_bytes_reserved_;
+
+    //! \brief bytes_in_use_ size of allocated chunks
+    size_t bytes_in_use_;
+
+    //! \brief peak_bytes_in_use_ maximum value of %bytes_in_use_
+    size_t peak_bytes_in_use_;
+};
+
+//!
+//! \brief The ArenaScope class Makes arena current for the calling thread
+//! while scope object exists. Previous arena is restored on scope exit
+//!
+class ArenaScope
+{
+public:
+    //!
+    //! \brief ArenaScope make arena current
+    //! \param arena arena to be used by %ArenaAllocator
+    //!
+    explicit ArenaScope (Arena & arena);
+    ~ArenaScope ();
+
+    ArenaScope (const ArenaScope &) = delete;
+    ArenaScope & operator= (const ArenaScope &) = delete;
+
+private:
+    //! \brief previous_ arena which was current before the scope
+    Arena * previous_;
+};
+
+//!
+//! \brief The ArenaAllocator class STL allocator taking memory from arena
+//! which is current for the thread on allocator creation. Works as plain
+//! new/delete if there is no current arena.
+//!
+//! Copies of containers use arena current for the copying thread, so
+//! containers can be copied out of the arena safely.
+//!
+template <typename T>
+class ArenaAllocator
+{
+public:
+    //! \brief value_type type of allocated objects
+    using value_type = T;
+
+    //!
+    //! \brief ArenaAllocator bind allocator to current arena
+    //!
+    ArenaAllocator ()
+        : arena_(Arena::GetCurrent()) {}
+
+    //!
+    //! \brief ArenaAllocator rebind allocator to other type
+    //! \param other allocator to be rebound
+    //!
+    template <typename U>
+    ArenaAllocator (const ArenaAllocator <U> & other)
+        : arena_(other.GetArena()) {}
+
+    //!
+    //! \brief allocate Allocate memory for %n objects
+    //! \param n number of objects
+    //! \return pointer to allocated memory
+    //!
+    T * allocate (size_t n)
+    {
+        if (arena_ == nullptr)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T *>(arena_->Allocate(n * sizeof(T)));
+    }
+
+    //!
+    //! \brief deallocate Free memory allocated by %allocate()
+    //! \param p pointer to memory
+    //! \param n number of objects
+    //!
+    void deallocate (T * p, size_t n)
+    {
+        if (arena_ == nullptr)
+        {
+            ::operator delete(p);
+            return;
+        }
+        arena_->Deallocate(p, n * sizeof(T));
+    }
+
+    //!
+    //! \brief select_on_container_copy_construction copy of container
+    //! uses current arena
+    //! \return allocator for the copy
+    //!
+    ArenaAllocator select_on_container_copy_construction () const
+    {
+        return ArenaAllocator();
+    }
+
+    //!
+    //! \brief GetArena Gives arena used by allocator
+    //! \return arena, nullptr if new/delete are used
+    //!
+    Arena * GetArena () const
+    {
+        return arena_;
+    }
+
+private:
+    //! \brief arena_ arena to take memory from, nullptr to use new/delete
+    Arena * arena_;
+};
+
+template <typename T, typename U>
+inline bool
+operator== (const ArenaAllocator <T> & l, const ArenaAllocator <U> & r)
+{
+    return (l.GetArena() == r.GetArena());
+}
+
+template <typename T, typename U>
+inline bool
+operator!= (const ArenaAllocator <T> & l, const ArenaAllocator <U> & r)
+{
+    return (l.GetArena() != r.GetArena());
+}
+
+#endif // TG_ARENA_H
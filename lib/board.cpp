@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "board.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+#include "tg_utils.h"
+
+const std::uint32_t Board::kUnreachable;
+
+Board::Board(const InputData &in)
+    : table_size_(in.GetTableSize())
+    , build_time_(0)
+{
+    for (coordinate_t i=1; i<=table_size_; ++i)
+    {
+        for (coordinate_t j=1; j<table_size_; ++j)
+        {
+            cells_.insert(std::make_pair(coordinates_t(i,j), BoardCell()));
+        }
+    }
+
+    // add walls on borders
+    for (coordinate_t i=1; i<=table_size_; ++i)
+    {
+        coordinates_t c_up    (i, 1);
+        coordinates_t c_down  (i, table_size_);
+        coordinates_t c_left  (1, i);
+        coordinates_t c_right (table_size_, i);
+
+        cells_[c_up].AddWall(Direction::North);
+        cells_[c_down].AddWall(Direction::South);
+        cells_[c_left].AddWall(Direction::West);
+        cells_[c_right].AddWall(Direction::East);
+    }
+
+    auto walls = in.GetWalls();
+    for (auto i : walls)
+    {
+        if (i.first.x == i.second.x)
+        {
+            // vertical neigbours
+            if (i.first.y < i.second.y)
+            {
+                // first is upper than second
+                cells_[i.first].AddWall(Direction::South);
+                cells_[i.second].AddWall(Direction::North);
+            }
+            else
+            {
+                cells_[i.first].AddWall(Direction::North);
+                cells_[i.second].AddWall(Direction::South);
+            }
+        }
+        else
+        {
+            // horisontal neighbours
+            if (i.first.x < i.second.x)
+            {
+                // first is left to second
+                cells_[i.first].AddWall(Direction::East);
+                cells_[i.second].AddWall(Direction::West);
+            }
+            else
+            {
+                cells_[i.first].AddWall(Direction::West);
+                cells_[i.second].AddWall(Direction::East);
+            }
+        }
+    }
+
+    auto holes = in.GetHoles();
+    ball_id_t hole_id = 1;
+    for (auto i : holes)
+    {
+        cells_[i].AddHole(hole_id);
+        holes_[hole_id] = i;
+        ++hole_id;
+    }
+
+    BuildMoveGraph();
+}
+
+coordinate_t Board::GetTableSize() const
+{
+    return table_size_;
+}
+
+const std::map<const coordinates_t, BoardCell> &Board::GetCells() const
+{
+    return cells_;
+}
+
+const std::map<ball_id_t, coordinates_t> &Board::GetHoles() const
+{
+    return holes_;
+}
+
+const move_graph_t &Board::GetMoveGraph() const
+{
+    return move_graph_;
+}
+
+std::uint32_t Board::GetDistance(ball_id_t hole, const coordinates_t &from) const
+{
+    if ((hole == INVALID_ID) || (hole > distances_.size()) || !IsOnBoard(from))
+    {
+        return kUnreachable;
+    }
+    return distances_[hole - 1][CellIndex(from)];
+}
+
+std::uint64_t Board::GetBuildTime() const
+{
+    return build_time_;
+}
+
+bool Board::IsOnBoard(const coordinates_t &cell) const
+{
+    return (cell.x >= 1) && (cell.x <= table_size_) &&
+           (cell.y >= 1) && (cell.y <= table_size_);
+}
+
+bool Board::SetWall(const wall_coordinates_t &wall, bool present)
+{
+    const coordinates_t & first = wall.first;
+    const coordinates_t & second = wall.second;
+    if (!IsOnBoard(first) || !IsOnBoard(second))
+    {
+        return false;
+    }
+
+    // side of the first cell, where the wall is
+    Direction side;
+    if ((first.x == second.x) && (first.y + 1 == second.y))
+    {
+        side = Direction::South;
+    }
+    else if ((first.x == second.x) && (second.y + 1 == first.y))
+    {
+        side = Direction::North;
+    }
+    else if ((first.y == second.y) && (first.x + 1 == second.x))
+    {
+        side = Direction::East;
+    }
+    else if ((first.y == second.y) && (second.x + 1 == first.x))
+    {
+        side = Direction::West;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (present)
+    {
+        cells_.at(first).AddWall(side);
+        cells_.at(second).AddWall(ReverseDirection(side));
+    }
+    else
+    {
+        cells_.at(first).RemoveWall(side);
+        cells_.at(second).RemoveWall(ReverseDirection(side));
+    }
+
+    // wall stops only balls moving along its line
+    RebuildLine(first, (side == Direction::North) || (side == Direction::South));
+    FindDistances();
+    return true;
+}
+
+bool Board::MoveHole(ball_id_t id, const coordinates_t &to)
+{
+    auto hole = holes_.find(id);
+    if ((hole == holes_.end()) || !IsOnBoard(to))
+    {
+        return false;
+    }
+    coordinates_t from = hole->second;
+    if (from == to)
+    {
+        return true;
+    }
+    if (cells_.at(to).HasHole())
+    {
+        return false;
+    }
+
+    cells_.at(from).RemoveHole();
+    cells_.at(to).AddHole(id);
+    hole->second = to;
+
+    RebuildLine(from, true);
+    RebuildLine(from, false);
+    if (to.x != from.x)
+    {
+        RebuildLine(to, true);
+    }
+    if (to.y != from.y)
+    {
+        RebuildLine(to, false);
+    }
+    FindDistances();
+    return true;
+}
+
+void Board::BuildMoveGraph()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    move_graph_.clear();
+    //TODO: run this code in parallel, using OpenMP or Intel TBB
+    for (auto i : cells_)
+    {
+        coordinates_t cell = i.first;
+        GraphItem gi;
+
+        FillGraphItemInDirection(gi, cell, Direction::North);
+        FillGraphItemInDirection(gi, cell, Direction::West);
+        FillGraphItemInDirection(gi, cell, Direction::South);
+        FillGraphItemInDirection(gi, cell, Direction::East);
+
+        move_graph_.insert(std::make_pair(cell, gi));
+    }
+    FindDistances();
+
+    build_time_ = std::chrono::duration_cast<std::chrono::microseconds>
+            (std::chrono::steady_clock::now() - start).count();
+}
+
+void Board::RebuildLine(const coordinates_t &cell, bool vertical)
+{
+    for (coordinate_t i=1; i<=table_size_; ++i)
+    {
+        coordinates_t current = vertical ? coordinates_t(cell.x, i)
+                                         : coordinates_t(i, cell.y);
+        GraphItem & gi = move_graph_.at(current);
+        for (auto to : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+        {
+            bool along = (to == Direction::North) || (to == Direction::South);
+            if (along == vertical)
+            {
+                gi.Clear(to);
+                FillGraphItemInDirection(gi, current, to);
+            }
+        }
+    }
+}
+
+void Board::FindDistances()
+{
+    const size_t cells_count = table_size_ * table_size_;
+
+    // moves back: cells from where single move ends in the cell
+    std::vector <std::vector <coordinates_t>> came_from (cells_count);
+    for (auto & item : move_graph_)
+    {
+        for (auto to : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+        {
+            const coordinates_t & next = item.second.GetNeigbour(to);
+            if (next != item.first)
+            {
+                came_from[CellIndex(next)].push_back(item.first);
+            }
+        }
+    }
+
+    distances_.assign(holes_.size(),
+                      std::vector <std::uint32_t> (cells_count, kUnreachable));
+    for (auto & hole : holes_)
+    {
+        std::vector <std::uint32_t> & distance = distances_[hole.first - 1];
+        std::deque <coordinates_t> queue;
+
+        // ball falls to its hole in one move if the hole is on the way,
+        // other holes on the way are closed
+        for (auto & item : move_graph_)
+        {
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                const auto & ids = item.second.GetHoleIdsOnWayTo(to);
+                if (std::find(ids.begin(), ids.end(), hole.first) != ids.end())
+                {
+                    distance[CellIndex(item.first)] = 1;
+                    queue.push_back(item.first);
+                    break;
+                }
+            }
+        }
+
+        while (!queue.empty())
+        {
+            coordinates_t cell = queue.front();
+            queue.pop_front();
+            std::uint32_t next_distance = distance[CellIndex(cell)] + 1;
+            for (auto & prev : came_from[CellIndex(cell)])
+            {
+                if (distance[CellIndex(prev)] == kUnreachable)
+                {
+                    distance[CellIndex(prev)] = next_distance;
+                    queue.push_back(prev);
+                }
+            }
+        }
+        distance[CellIndex(hole.second)] = 0;
+    }
+}
+
+std::pair<Ball::CollisionResult, coordinates_t>
+Board::RollBall(const coordinates_t &start_from,
+                const Direction to) const
+{
+    coordinates_t current_cell = start_from;
+    coordinates_t next_cell = current_cell;
+    Ball::CollisionResult collision = Ball::CollisionResult::Pass;
+    Ball ball (INVALID_ID);
+
+    do {
+        current_cell = next_cell;
+        collision = ball.CollisionWith(cells_.at(current_cell), to);
+
+        // If ball stands on the cell with hole during start of the move
+        // it cannot fall to the hole now. It has fallen here
+        // in previous move
+        switch (collision)
+        {
+        case Ball::CollisionResult::FallToHoleOrPass:
+            if (current_cell == start_from)
+            {
+                collision = Ball::CollisionResult::Pass;
+            }
+            break;
+        case Ball::CollisionResult::FallToHoleOrStop:
+            if (current_cell == start_from)
+            {
+                collision = Ball::CollisionResult::Stop;
+            }
+
+            break;
+        case Ball::CollisionResult::Stop:
+            // fallthrough
+        case Ball::CollisionResult::Pass:
+            // nothing to do here
+            break;
+        }
+
+        next_cell = GetNeighbourCell(current_cell, to);
+    } while (collision == Ball::CollisionResult::Pass);
+
+    return std::make_pair(collision, current_cell);
+}
+
+void Board::FillGraphItemInDirection(GraphItem &gi,
+                                     coordinates_t current_cell,
+                                     Direction move_to) const
+{
+    Ball::CollisionResult collision = Ball::CollisionResult::Pass;
+    coordinates_t start_cell = current_cell;
+    coordinates_t collision_cell;
+    do {
+        auto c_result = RollBall(start_cell, move_to);
+        collision = c_result.first;
+        collision_cell = c_result.second;
+        switch (collision)
+        {
+        case Ball::CollisionResult::Pass:
+            break;
+        case Ball::CollisionResult::Stop:
+            gi.AddNeighbour(move_to, collision_cell);
+            break;
+        case Ball::CollisionResult::FallToHoleOrStop:
+            collision = Ball::CollisionResult::Stop;
+            gi.AddNeighbour(move_to, collision_cell);
+            gi.AddHole(move_to, collision_cell,
+                       cells_.at(collision_cell).HoleId());
+            break;
+        case Ball::CollisionResult::FallToHoleOrPass:
+            gi.AddHole(move_to, collision_cell,
+                       cells_.at(collision_cell).HoleId());
+            collision_cell = GetNeighbourCell (collision_cell, move_to);
+            break;
+        }
+        start_cell = collision_cell;
+
+    } while (collision != Ball::CollisionResult::Stop);
+}
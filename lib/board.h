@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_BOARD_H
+#define TG_BOARD_H
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "tg_types.h"
+#include "input.h"
+#include "board_cell.h"
+#include "ball.h"
+#include "move_graph.h"
+
+//!
+//! \brief The Board class Static part of the game: walls, holes and
+//! everything computed from them. Board doesn't know about balls, so one
+//! board can be shared by many games with different start positions of
+//! balls. Constant board is never changed, all its methods can be called
+//! from several threads simultaneously
+//!
+class Board
+{
+public:
+    //! \brief kUnreachable distance to the hole, which cannot be reached
+    static const std::uint32_t kUnreachable = UINT32_MAX;
+
+    //!
+    //! \brief Board Create board from input data and build its move graph.
+    //! Balls of input data are ignored. Input errors must be handled outside
+    //! of this class
+    //! \param in input data
+    //!
+    Board (const InputData & in);
+    ~Board () = default;
+
+    //!
+    //! \brief GetTableSize Gives size of the board
+    //! \return board size
+    //!
+    coordinate_t GetTableSize () const;
+
+    //!
+    //! \brief GetCells gives cells of the board with their walls and holes
+    //! \return board cells
+    //!
+    const std::map <const coordinates_t, BoardCell> & GetCells () const;
+
+    //!
+    //! \brief GetHoles gives positions of the holes
+    //! \return hole positions by hole id
+    //!
+    const std::map <ball_id_t, coordinates_t> & GetHoles () const;
+
+    //!
+    //! \brief GetMoveGraph gives graph of moves on the board
+    //! \return move graph
+    //!
+    const move_graph_t & GetMoveGraph () const;
+
+    //!
+    //! \brief GetDistance gives number of moves needed by single ball to
+    //! reach its hole, when there are no other balls and other holes are
+    //! closed. It's an estimation only: other balls may stop the ball on
+    //! the way and make the path both longer and shorter
+    //! \param hole hole id
+    //! \param from cell where ball stands
+    //! \return number of moves, %kUnreachable if ball cannot get to the hole
+    //!
+    std::uint32_t GetDistance (ball_id_t hole, const coordinates_t & from) const;
+
+    //!
+    //! \brief GetBuildTime time spent to build move graph and distance
+    //! tables from scratch
+    //! \return time in microseconds
+    //!
+    std::uint64_t GetBuildTime () const;
+
+    //!
+    //! \brief IsOnBoard check if cell is on the board
+    //! \param cell cell coordinates
+    //! \return true if cell is on the board
+    //!
+    bool IsOnBoard (const coordinates_t & cell) const;
+
+    //!
+    //! \brief SetWall add or remove wall between two neighbour cells. Only
+    //! the row or the column of the wall is rebuilt in move graph
+    //! \param wall wall position
+    //! \param present true to add the wall, false to remove it
+    //! \return false if cells are not neighbours on the board
+    //!
+    bool SetWall (const wall_coordinates_t & wall, bool present);
+
+    //!
+    //! \brief MoveHole move hole to other cell. Only rows and columns of
+    //! old and new hole positions are rebuilt in move graph. Balls are not
+    //! known to the board, caller must check that the cell is free
+    //! \param id hole id
+    //! \param to new hole position
+    //! \return false if there is no such hole or the cell is out of board
+    //! or holds other hole
+    //!
+    bool MoveHole (ball_id_t id, const coordinates_t & to);
+
+    //!
+    //! \brief BuildMoveGraph build move graph and distance tables from
+    //! scratch
+    //!
+    void BuildMoveGraph ();
+
+private:
+    //! \brief table_size_ size of board table
+    coordinate_t table_size_;
+
+    //! \brief cells_ cells of the board
+    std::map <const coordinates_t, BoardCell> cells_;
+
+    //! \brief holes_ holes positions
+    std::map <ball_id_t, coordinates_t> holes_;
+
+    //! \brief move_graph_ graph of moves on the board
+    move_graph_t move_graph_;
+
+    //! \brief distances_ distances to every hole, indexed by hole id - 1
+    //! and cell index (y - 1) * size + (x - 1)
+    std::vector <std::vector <std::uint32_t>> distances_;
+
+    //! \brief build_time_ time of last %BuildMoveGraph() call, microseconds
+    std::uint64_t build_time_;
+
+    //!
+    //! \brief CellIndex gives index of the cell in distance tables
+    //! \param cell cell coordinates
+    //! \return cell index
+    //!
+    size_t CellIndex (const coordinates_t & cell) const
+    {
+        return (cell.y - 1) * table_size_ + (cell.x - 1);
+    }
+
+    //!
+    //! \brief RebuildLine rebuild move graph for moves along one row or
+    //! column
+    //! \param cell any cell of the line
+    //! \param vertical true for column, false for row
+    //!
+    void RebuildLine (const coordinates_t & cell, bool vertical);
+
+    //!
+    //! \brief FindDistances fill distance tables using move graph
+    //!
+    void FindDistances ();
+
+    //!
+    //! \brief RollBall Roll ball from current position in specified direction
+    //! \param start_from start move position
+    //! \param to desired direction
+    //! \return cell where ball will stop and why
+    //!
+    std::pair <Ball::CollisionResult, coordinates_t>
+    RollBall(const coordinates_t & start_from,
+             const Direction to) const;
+
+    //!
+    //! \brief FillGraphItemInDirection Fiil graph node in specified direction
+    //! \param gi graph node
+    //! \param current_cell cell graph node attached to
+    //! \param move_to direction
+    //!
+    void FillGraphItemInDirection (GraphItem & gi,
+                                   coordinates_t current_cell,
+                                   Direction move_to) const;
+};
+
+#endif // TG_BOARD_H
@@ -71,6 +71,25 @@ void BoardCell::AddWall(Direction at)
     }
 }
 
+void BoardCell::RemoveWall(Direction at)
+{
+    switch (at)
+    {
+    case Direction::East:
+        walls_.east = false;
+        break;
+    case Direction::West:
+        walls_.west = false;
+        break;
+    case Direction::North:
+        walls_.north = false;
+        break;
+    case Direction::South:
+        walls_.south = false;
+        break;
+    }
+}
+
 bool BoardCell::HasWall(Direction at) const
 {
     switch (at)
@@ -93,6 +112,12 @@ void BoardCell::AddHole(ball_id_t id)
     hole_id_ = id;
 }
 
+void BoardCell::RemoveHole()
+{
+    has_hole_ = false;
+    hole_id_ = INVALID_ID;
+}
+
 bool BoardCell::HasHole() const
 {
     return has_hole_;
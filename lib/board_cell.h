@@ -71,6 +71,13 @@ public:
     //!
     void AddWall (Direction at);
 
+    //!
+    //! \brief RemoveWall remove wall from the cell on specific direction
+    //! Neigbour cell must lose the wall on corresponding side too
+    //! \param at side of the wall
+    //!
+    void RemoveWall (Direction at);
+
     //!
     //! \brief HasWall Check if cell have walls on requested side
     //! \param at side
@@ -85,6 +92,11 @@ public:
     //!
     void AddHole (ball_id_t id);
 
+    //!
+    //! \brief RemoveHole Remove hole from the cell
+    //!
+    void RemoveHole ();
+
     //!
     //! \brief HasHole Check if board cell has holes
     //! \return true if cell has hole
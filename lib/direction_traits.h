@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_DIRECTION_TRAITS_H
+#define TG_DIRECTION_TRAITS_H
+
+#include "tg_types.h"
+
+//! \file
+
+//!
+//! \brief The DirectionTraits struct Compile time description of the move
+//! direction. Lets hot loops be instantiated for every direction instead of
+//! switching on the direction for every ball
+//!
+template <Direction D>
+struct DirectionTraits;
+
+template <>
+struct DirectionTraits <Direction::North>
+{
+    static constexpr bool kVertical = true;                 //!< moves along column
+    static constexpr int kStep = -1;                        //!< coordinate change
+    static constexpr Direction kReverse = Direction::South; //!< opposite direction
+};
+
+template <>
+struct DirectionTraits <Direction::West>
+{
+    static constexpr bool kVertical = false;                //!< moves along row
+    static constexpr int kStep = -1;                        //!< coordinate change
+    static constexpr Direction kReverse = Direction::East;  //!< opposite direction
+};
+
+template <>
+struct DirectionTraits <Direction::South>
+{
+    static constexpr bool kVertical = true;                 //!< moves along column
+    static constexpr int kStep = 1;                         //!< coordinate change
+    static constexpr Direction kReverse = Direction::North; //!< opposite direction
+};
+
+template <>
+struct DirectionTraits <Direction::East>
+{
+    static constexpr bool kVertical = false;                //!< moves along row
+    static constexpr int kStep = 1;                         //!< coordinate change
+    static constexpr Direction kReverse = Direction::West;  //!< opposite direction
+};
+
+//!
+//! \brief GetNeighbourCell get neighbour cell in direction %D
+//! \param cell cell coordinates
+//! \return neighbour cell coordinates
+//!
+template <Direction D>
+inline coordinates_t GetNeighbourCell (const coordinates_t & cell)
+{
+    return DirectionTraits<D>::kVertical
+            ? coordinates_t(cell.x, cell.y + DirectionTraits<D>::kStep)
+            : coordinates_t(cell.x + DirectionTraits<D>::kStep, cell.y);
+}
+
+//!
+//! \brief GetLine get row or column the ball rolls along in direction %D
+//! \param cell cell coordinates
+//! \return column for vertical moves, row for horizontal ones
+//!
+template <Direction D>
+inline coordinate_t GetLine (const coordinates_t & cell)
+{
+    return DirectionTraits<D>::kVertical ? cell.x : cell.y;
+}
+
+//!
+//! \brief IsNotBehind check if cell is not behind other one in the same
+//! line when moving in direction %D
+//! \param cell checked cell
+//! \param other other cell in the same line
+//! \return true if %cell is the same as %other or ahead of it
+//!
+template <Direction D>
+inline bool IsNotBehind (const coordinates_t & cell, const coordinates_t & other)
+{
+    coordinate_t position = DirectionTraits<D>::kVertical ? cell.y : cell.x;
+    coordinate_t other_position = DirectionTraits<D>::kVertical ? other.y : other.x;
+    return (DirectionTraits<D>::kStep < 0) ? (position <= other_position)
+                                           : (position >= other_position);
+}
+
+#endif // TG_DIRECTION_TRAITS_H
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "frontier.h"
+
+#include <algorithm>
+
+CompressedFrontier::Reader::Reader(const CompressedFrontier &frontier)
+    : frontier_(&frontier)
+    , block_(0)
+    , position_(0)
+    , count_(0)
+{
+}
+
+bool CompressedFrontier::Reader::Next(state_t &state)
+{
+    if (position_ == count_)
+    {
+        if (block_ == frontier_->blocks_.size())
+        {
+            return false;
+        }
+        count_ = frontier_->Decode(block_++, decoded_);
+        position_ = 0;
+    }
+    state = decoded_[position_++];
+    return true;
+}
+
+CompressedFrontier::CompressedFrontier()
+    : size_(0)
+    , last_(0)
+{
+}
+
+void CompressedFrontier::Assign(std::vector<state_t> &states)
+{
+    Clear();
+    std::sort(states.begin(), states.end());
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        if ((i == 0) || (states[i] != states[i - 1]))
+        {
+            Append(states[i]);
+        }
+    }
+}
+
+CompressedFrontier CompressedFrontier::Merge(const CompressedFrontier &a,
+                                             const CompressedFrontier &b)
+{
+    CompressedFrontier result;
+    Reader ra (a);
+    Reader rb (b);
+    state_t sa = 0;
+    state_t sb = 0;
+    bool has_a = ra.Next(sa);
+    bool has_b = rb.Next(sb);
+
+    while (has_a || has_b)
+    {
+        if (has_a && (!has_b || (sa < sb)))
+        {
+            result.Append(sa);
+            has_a = ra.Next(sa);
+        }
+        else if (has_b && (!has_a || (sb < sa)))
+        {
+            result.Append(sb);
+            has_b = rb.Next(sb);
+        }
+        else
+        {
+            // the same state in both frontiers
+            result.Append(sa);
+            has_a = ra.Next(sa);
+            has_b = rb.Next(sb);
+        }
+    }
+    return result;
+}
+
+CompressedFrontier
+CompressedFrontier::Difference(const CompressedFrontier &a,
+                               const std::vector<CompressedFrontier> &excluded)
+{
+    std::vector <Reader> readers;
+    std::vector <state_t> current (excluded.size());
+    std::vector <bool> has (excluded.size());
+    for (size_t i = 0; i < excluded.size(); ++i)
+    {
+        readers.push_back(Reader(excluded[i]));
+        has[i] = readers[i].Next(current[i]);
+    }
+
+    CompressedFrontier result;
+    Reader reader (a);
+    state_t state;
+    while (reader.Next(state))
+    {
+        bool found = false;
+        for (size_t i = 0; (i < readers.size()) && !found; ++i)
+        {
+            while (has[i] && (current[i] < state))
+            {
+                has[i] = readers[i].Next(current[i]);
+            }
+            found = has[i] && (current[i] == state);
+        }
+        if (!found)
+        {
+            result.Append(state);
+        }
+    }
+    return result;
+}
+
+bool CompressedFrontier::Contains(state_t state) const
+{
+    auto next = std::upper_bound(blocks_.begin(), blocks_.end(), state,
+                                 [] (state_t s, const Block & b)
+    {
+        return s < b.first;
+    });
+    if (next == blocks_.begin())
+    {
+        return false;
+    }
+
+    std::array <state_t, kBlockSize> states;
+    size_t count = Decode(static_cast<size_t>(next - blocks_.begin()) - 1, states);
+    return std::binary_search(states.begin(), states.begin() + count, state);
+}
+
+void CompressedFrontier::Clear()
+{
+    std::vector <Block>().swap(blocks_);
+    std::vector <std::uint8_t>().swap(data_);
+    size_ = 0;
+    last_ = 0;
+}
+
+size_t CompressedFrontier::GetSize() const
+{
+    return size_;
+}
+
+size_t CompressedFrontier::GetBytes() const
+{
+    return blocks_.size() * sizeof(Block) + data_.size();
+}
+
+size_t CompressedFrontier::GetReservedBytes() const
+{
+    return blocks_.capacity() * sizeof(Block) + data_.capacity();
+}
+
+void CompressedFrontier::Append(state_t state)
+{
+    if (blocks_.empty() || (blocks_.back().count == kBlockSize))
+    {
+        blocks_.push_back({state, static_cast<std::uint32_t>(data_.size()), 1});
+    }
+    else
+    {
+        // varint: 7 bits in every byte, high bit is set if more bytes follow
+        state_t delta = state - last_;
+        while (delta >= 0x80)
+        {
+            data_.push_back(static_cast<std::uint8_t>(delta | 0x80));
+            delta >>= 7;
+        }
+        data_.push_back(static_cast<std::uint8_t>(delta));
+        ++blocks_.back().count;
+    }
+    last_ = state;
+    ++size_;
+}
+
+size_t CompressedFrontier::Decode(size_t block,
+                                  std::array<state_t, kBlockSize> &states) const
+{
+    const Block & b = blocks_[block];
+    const std::uint8_t * data = data_.data() + b.offset;
+    state_t state = b.first;
+    states[0] = state;
+    for (size_t i = 1; i < b.count; ++i)
+    {
+        state_t delta = 0;
+        unsigned shift = 0;
+        std::uint8_t byte;
+        do
+        {
+            byte = *data++;
+            delta |= static_cast<state_t>(byte & 0x7F) << shift;
+            shift += 7;
+        }
+        while (byte & 0x80);
+        state += delta;
+        states[i] = state;
+    }
+    return b.count;
+}
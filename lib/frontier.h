@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_FRONTIER_H
+#define TG_FRONTIER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//!
+//! \brief The CompressedFrontier class Sorted set of packed game states.
+//!
+//! States are kept in ascending order and split to blocks of %kBlockSize
+//! states. First state of the block is stored as is, others are stored as
+//! varint encoded differences to the previous state. Neighbour states of
+//! one search layer differ in a few low bits, so usually every state takes
+//! one or two bytes instead of eight. States are decoded block by block
+//! while reading.
+//!
+class CompressedFrontier
+{
+public:
+    //! \brief state_t packed game state
+    using state_t = std::uint64_t;
+
+    //! \brief kBlockSize number of states in one block
+    static const size_t kBlockSize = 64;
+
+    //!
+    //! \brief The Reader class Reads states of the frontier in ascending
+    //! order. Frontier must not be changed while it is read
+    //!
+    class Reader
+    {
+    public:
+        //!
+        //! \brief Reader Start reading from the first state
+        //! \param frontier frontier to be read
+        //!
+        explicit Reader (const CompressedFrontier & frontier);
+
+        //!
+        //! \brief Next read next state
+        //! \param state next state
+        //! \return false if all states are already read
+        //!
+        bool Next (state_t & state);
+
+    private:
+        //! \brief frontier_ frontier being read
+        const CompressedFrontier * frontier_;
+
+        //! \brief block_ next block to be decoded
+        size_t block_;
+
+        //! \brief position_ next state in %decoded_
+        size_t position_;
+
+        //! \brief count_ number of states in %decoded_
+        size_t count_;
+
+        //! \brief decoded_ states of current block
+        std::array <state_t, kBlockSize> decoded_;
+    };
+
+    CompressedFrontier ();
+
+    //!
+    //! \brief Assign replace content of the frontier
+    //! \param states states in any order, may have duplicates. Vector is
+    //! sorted in place
+    //!
+    void Assign (std::vector <state_t> & states);
+
+    //!
+    //! \brief Merge unite two frontiers, every state is kept only once
+    //! \param a first frontier
+    //! \param b second frontier
+    //! \return frontier of states of both frontiers
+    //!
+    static CompressedFrontier Merge (const CompressedFrontier & a,
+                                     const CompressedFrontier & b);
+
+    //!
+    //! \brief Difference drop states which are found in other frontiers
+    //! \param a frontier
+    //! \param excluded frontiers of states to be dropped
+    //! \return frontier of states of %a not found in any of %excluded
+    //!
+    static CompressedFrontier Difference (const CompressedFrontier & a,
+                                          const std::vector <CompressedFrontier> & excluded);
+
+    //!
+    //! \brief Contains check if state is in the frontier. Only one block is
+    //! decoded
+    //! \param state state to be found
+    //! \return true if state is found
+    //!
+    bool Contains (state_t state) const;
+
+    //!
+    //! \brief Clear drop all states and release memory
+    //!
+    void Clear ();
+
+    //!
+    //! \brief GetSize number of states
+    //! \return states count
+    //!
+    size_t GetSize () const;
+
+    //!
+    //! \brief GetBytes memory used by encoded states and block index
+    //! \return size in bytes
+    //!
+    size_t GetBytes () const;
+
+    //!
+    //! \brief GetReservedBytes memory reserved for encoded states and
+    //! block index
+    //! \return size in bytes
+    //!
+    size_t GetReservedBytes () const;
+
+private:
+    //!
+    //! \brief The Block struct Index entry of one block
+    //!
+    struct Block
+    {
+        state_t first;          //!< first state of the block
+        std::uint32_t offset;   //!< offset of encoded differences in %data_
+        std::uint32_t count;    //!< number of states in the block
+    };
+
+    //! \brief blocks_ blocks index
+    std::vector <Block> blocks_;
+
+    //! \brief data_ encoded differences of all blocks
+    std::vector <std::uint8_t> data_;
+
+    //! \brief size_ number of states
+    size_t size_;
+
+    //! \brief last_ last appended state
+    state_t last_;
+
+    //!
+    //! \brief Append add state to the end of frontier
+    //! \param state state, bigger than all the states of frontier
+    //!
+    void Append (state_t state);
+
+    //!
+    //! \brief Decode decode all states of the block
+    //! \param block block index
+    //! \param states decoded states
+    //! \return number of decoded states
+    //!
+    size_t Decode (size_t block, std::array <state_t, kBlockSize> & states) const;
+};
+
+#endif // TG_FRONTIER_H
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "generator.h"
+#include "input.h"
+#include "table.h"
+
+Random::Random (std::uint64_t seed)
+    : state_(seed * 2 + 1)
+{
+}
+
+std::uint32_t Random::Next (std::uint32_t bound)
+{
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return static_cast<std::uint32_t>(((state_ * 2685821657736338717ULL) >> 32) % bound);
+}
+
+bool IsValid (const GeneratorOptions & options)
+{
+    if ((options.table_size == 0) || (options.balls_count == 0))
+    {
+        return false;
+    }
+    if (options.balls_count * 2 > options.table_size * options.table_size)
+    {
+        // not enough cells for balls and holes
+        return false;
+    }
+    if ((options.max_moves != 0) && (options.min_moves > options.max_moves))
+    {
+        return false;
+    }
+    return options.wall_percent <= 100;
+}
+
+input_data_t GeneratePuzzle (const GeneratorOptions & options,
+                             std::uint64_t seed)
+{
+    Random random (seed);
+    coordinate_t size = options.table_size;
+
+    std::vector <coordinates_t> cells;
+    for (coordinate_t y = 1; y <= size; ++y)
+    {
+        for (coordinate_t x = 1; x <= size; ++x)
+        {
+            cells.push_back(coordinates_t(x, y));
+        }
+    }
+    for (size_t i = cells.size() - 1; i > 0; --i)
+    {
+        std::swap(cells[i], cells[random.Next(static_cast<std::uint32_t>(i + 1))]);
+    }
+
+    input_data_t walls;
+    for (coordinate_t y = 1; y <= size; ++y)
+    {
+        for (coordinate_t x = 1; x <= size; ++x)
+        {
+            if ((x < size) && (random.Next(100) < options.wall_percent))
+            {
+                walls.insert(walls.end(), {x, y, x + 1, y});
+            }
+            if ((y < size) && (random.Next(100) < options.wall_percent))
+            {
+                walls.insert(walls.end(), {x, y, x, y + 1});
+            }
+        }
+    }
+
+    input_data_t puzzle = {size, options.balls_count,
+                           static_cast<coordinate_t>(walls.size() / 4)};
+    // first cells are balls, next ones are holes
+    for (coordinate_t i = 0; i < options.balls_count * 2; ++i)
+    {
+        puzzle.push_back(cells[i].x);
+        puzzle.push_back(cells[i].y);
+    }
+    puzzle.insert(puzzle.end(), walls.begin(), walls.end());
+
+    return puzzle;
+}
+
+namespace
+{
+
+//!
+//! \brief MixSeed derive independent seed for every game (splitmix64)
+//! \param seed base seed
+//! \param index game index
+//! \return game seed
+//!
+std::uint64_t MixSeed (std::uint64_t seed, std::uint64_t index)
+{
+    std::uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//!
+//! \brief IsMatching Check if best solution of the game has required length
+//! \param options generator options
+//! \param puzzle game
+//! \return true if game passes the filter
+//!
+bool IsMatching (const GeneratorOptions & options, const input_data_t & puzzle)
+{
+    if (options.max_moves == 0)
+    {
+        return true;
+    }
+
+    InputData data (puzzle);
+    if (data.GetDataStatus() != InputData::Status::Ok)
+    {
+        return false;
+    }
+
+    GameTable table (data);
+    table.SetMaxMoves(options.max_moves);
+    table.CalculateMoves();
+
+    std::list <moves_sequence_t> moves = table.GetMoves();
+    return !moves.empty() && (moves.front().size() >= options.min_moves);
+}
+
+} // namespace
+
+bool GeneratePuzzle (const GeneratorOptions & options, std::uint64_t index,
+                     input_data_t & puzzle)
+{
+    if (!IsValid(options))
+    {
+        return false;
+    }
+
+    std::uint64_t seed = MixSeed(options.seed, index);
+    size_t attempts = std::max <size_t> (options.max_attempts, 1);
+    for (size_t i = 0; i < attempts; ++i)
+    {
+        puzzle = GeneratePuzzle(options, seed);
+        if (IsMatching(options, puzzle))
+        {
+            return true;
+        }
+        seed = MixSeed(seed, index);
+    }
+    puzzle.clear();
+    return false;
+}
+
+size_t GeneratePuzzles (const GeneratorOptions & options, std::uint64_t count,
+                        unsigned threads, const puzzle_sink_t & sink)
+{
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::atomic <std::uint64_t> next_index (0);
+    std::mutex lock;
+    std::condition_variable done;
+    // games which are ready but wait for the previous ones to be passed
+    // to the sink
+    std::map <std::uint64_t, input_data_t> ready;
+    std::uint64_t next_to_sink = 0;
+    size_t generated = 0;
+
+    auto worker = [&] ()
+    {
+        while (true)
+        {
+            std::uint64_t index = next_index++;
+            if (index >= count)
+            {
+                return;
+            }
+
+            input_data_t puzzle;
+            GeneratePuzzle(options, index, puzzle);
+
+            std::unique_lock <std::mutex> guard (lock);
+            // don't let fast workers run too far ahead of slow ones
+            done.wait(guard, [&] ()
+                { return index < next_to_sink + threads * 64; });
+
+            ready.emplace(index, std::move(puzzle));
+            while (!ready.empty() && (ready.begin()->first == next_to_sink))
+            {
+                if (!ready.begin()->second.empty())
+                {
+                    sink(next_to_sink, ready.begin()->second);
+                    ++generated;
+                }
+                ready.erase(ready.begin());
+                ++next_to_sink;
+            }
+            done.notify_all();
+        }
+    };
+
+    std::vector <std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto & t : workers)
+    {
+        t.join();
+    }
+
+    return generated;
+}
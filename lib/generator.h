@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_GENERATOR_H
+#define TG_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "tg_types.h"
+
+//! \file
+
+//!
+//! \brief The Random class Deterministic pseudo random generator
+//! (xorshift64*). Doesn't depend on standard library implementation, so
+//! generated games are the same everywhere
+//!
+class Random
+{
+public:
+    //!
+    //! \brief Random Create generator
+    //! \param seed initial seed, any value is allowed
+    //!
+    explicit Random (std::uint64_t seed);
+
+    //!
+    //! \brief Next gives next random number in range [0, bound)
+    //! \param bound upper bound, must be greater than zero
+    //! \return random number
+    //!
+    std::uint32_t Next (std::uint32_t bound);
+
+private:
+    //! \brief state_ generator state, never zero
+    std::uint64_t state_;
+};
+
+//!
+//! \brief The GeneratorOptions struct Parameters of generated games
+//!
+struct GeneratorOptions
+{
+    //! \brief table_size size of the board
+    coordinate_t table_size;
+
+    //! \brief balls_count number of balls and holes
+    coordinate_t balls_count;
+
+    //! \brief wall_percent probability of wall between every two neighbour
+    //! cells, percents
+    unsigned wall_percent;
+
+    //! \brief seed base seed, every game is derived from it and game index
+    std::uint64_t seed;
+
+    //! \brief min_moves minimum length of best solution, 0 if game doesn't
+    //! need to be solved
+    size_t min_moves;
+
+    //! \brief max_moves maximum length of best solution, 0 if game doesn't
+    //! need to be solved
+    size_t max_moves;
+
+    //! \brief max_attempts number of random games tried to find one
+    //! matching solution length filter
+    size_t max_attempts;
+
+    GeneratorOptions ()
+        : table_size(4), balls_count(2), wall_percent(10), seed(1)
+        , min_moves(0), max_moves(0), max_attempts(1000) {}
+};
+
+//!
+//! \brief IsValid Check if game with such options can be generated
+//! \param options generator options
+//! \return true if options are valid
+//!
+bool IsValid (const GeneratorOptions & options);
+
+//!
+//! \brief GeneratePuzzle Create random game. Balls and holes occupy different
+//! cells, every wall between neighbour cells is set with given probability.
+//! Solution length filter is not applied
+//! \param options generator options
+//! \param seed random seed
+//! \return game in input data format
+//!
+input_data_t GeneratePuzzle (const GeneratorOptions & options,
+                             std::uint64_t seed);
+
+//!
+//! \brief GeneratePuzzle Create game number %index. The same options and
+//! index always give the same game. If solution length filter is set,
+//! random games are solved until matching one is found
+//! \param options generator options
+//! \param index game index
+//! \param puzzle generated game
+//! \return false if no matching game found in %max_attempts
+//!
+bool GeneratePuzzle (const GeneratorOptions & options, std::uint64_t index,
+                     input_data_t & puzzle);
+
+//! \brief puzzle_sink_t receiver of generated games: index and game
+using puzzle_sink_t = std::function<void (std::uint64_t, const input_data_t &)>;
+
+//!
+//! \brief GeneratePuzzles Create %count games in parallel. Games are passed
+//! to %sink one by one in index order, games which cannot be generated are
+//! skipped
+//! \param options generator options
+//! \param count number of games
+//! \param threads number of worker threads, 0 for hardware concurrency
+//! \param sink receiver of generated games
+//! \return number of generated games
+//!
+size_t GeneratePuzzles (const GeneratorOptions & options, std::uint64_t count,
+                        unsigned threads, const puzzle_sink_t & sink);
+
+#endif // TG_GENERATOR_H
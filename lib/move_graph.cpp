@@ -33,29 +33,14 @@
 #include "tg_utils.h"
 
 GraphItem::GraphItem()
-    : neighbour_north_({0,0})
-    , neighbour_west_ ({0,0})
-    , neighbour_south_({0,0})
-    , neighbour_east_ ({0,0})
-    , invalid_coordinates_({0,0})
+    : hole_masks_{0, 0, 0, 0}
 {
 
 }
 
 const coordinates_t &GraphItem::GetNeigbour(Direction at) const
 {
-    switch (at)
-    {
-    case Direction::North:
-        return neighbour_north_;
-    case Direction::West:
-        return neighbour_west_;
-    case Direction::South:
-        return neighbour_south_;
-    case Direction::East:
-        return neighbour_east_;
-    }
-    return invalid_coordinates_;
+    return neighbours_[static_cast<size_t>(at)];
 }
 
 const std::vector<coordinates_t> &GraphItem::GetHolesOnWayTo(Direction to) const
@@ -76,25 +61,50 @@ const std::vector<coordinates_t> &GraphItem::GetHolesOnWayTo(Direction to) const
 
 void GraphItem::AddNeighbour(Direction at, coordinates_t cell)
 {
+    neighbours_[static_cast<size_t>(at)] = cell;
+}
+
+void GraphItem::Clear(Direction at)
+{
+    neighbours_[static_cast<size_t>(at)] = coordinates_t();
+    hole_masks_[static_cast<size_t>(at)] = 0;
+    hole_ids_[static_cast<size_t>(at)].clear();
+
     switch (at)
     {
     case Direction::North:
-        neighbour_north_ = cell;
+        holes_north_.clear();
         break;
     case Direction::West:
-        neighbour_west_  = cell;
+        holes_west_.clear();
         break;
     case Direction::South:
-        neighbour_south_ = cell;
+        holes_south_.clear();
         break;
     case Direction::East:
-        neighbour_east_  = cell;
+        holes_east_.clear();
         break;
     }
 }
 
-void GraphItem::AddHole(Direction at, coordinates_t cell)
+hole_mask_t GraphItem::GetHoleMask(Direction to) const
+{
+    return hole_masks_[static_cast<size_t>(to)];
+}
+
+const std::vector<ball_id_t> &GraphItem::GetHoleIdsOnWayTo(Direction to) const
+{
+    return hole_ids_[static_cast<size_t>(to)];
+}
+
+void GraphItem::AddHole(Direction at, coordinates_t cell, ball_id_t id)
 {
+    if (id != INVALID_ID)
+    {
+        hole_masks_[static_cast<size_t>(at)] |= HoleBit(id);
+        hole_ids_[static_cast<size_t>(at)].push_back(id);
+    }
+
     switch (at)
     {
     case Direction::North:
@@ -33,9 +33,28 @@
 #define TG_MOVE_GRAPH_H
 
 #include "tg_types.h"
+#include <cstdint>
+#include <map>
 #include <vector>
 #include <ostream>
 
+//! \brief Set of holes, bit (id - 1) stands for the hole with id
+using hole_mask_t = std::uint64_t;
+
+//! \brief kMaxMaskedHoleId holes with greater ids cannot be put to the mask
+const ball_id_t kMaxMaskedHoleId = 64;
+
+//!
+//! \brief HoleBit Get mask of single hole
+//! \param id hole id
+//! \return mask with single bit set, empty mask if id cannot be masked
+//!
+inline hole_mask_t HoleBit (ball_id_t id)
+{
+    return ((id != INVALID_ID) && (id <= kMaxMaskedHoleId))
+            ? (hole_mask_t(1) << (id - 1)) : 0;
+}
+
 //!
 //! \brief The GraphItem class node of possible movement graph
 //!
@@ -52,6 +71,17 @@ public:
     //!
     const coordinates_t & GetNeigbour(Direction at) const;
 
+    //!
+    //! \brief GetNeigbour Gives the next node at direction known at compile
+    //! time
+    //! \return cell coordinates where ball would be if go to direction %D
+    //!
+    template <Direction D>
+    const coordinates_t & GetNeigbour() const
+    {
+        return neighbours_[static_cast<size_t>(D)];
+    }
+
     //!
     //! \brief GetHolesOnWayTo Between node and its neighbour can be holes
     //! and ball can fall there
@@ -71,22 +101,63 @@ public:
     //! \brief AddHole adds hole between node and its neighbour on specific direction
     //! \param at direction
     //! \param cell hole cell address
+    //! \param id hole id, holes with invalid id are not added to hole mask
     //!
-    void AddHole      (Direction at, coordinates_t cell);
+    void AddHole      (Direction at, coordinates_t cell,
+                       ball_id_t id = INVALID_ID);
 
-private:
-    //! \brief neighbour_north_ Northen neigbour
-    coordinates_t neighbour_north_;
+    //!
+    //! \brief Clear forget neighbour and holes on specific direction
+    //! \param at direction
+    //!
+    void Clear        (Direction at);
 
-    //! \brief neighbour_north_ Western neigbour
-    coordinates_t neighbour_west_;
+    //!
+    //! \brief GetHoleMask Gives all holes between node and its neighbour
+    //! \param to direction
+    //! \return set of holes
+    //!
+    hole_mask_t GetHoleMask (Direction to) const;
 
-    //! \brief neighbour_north_ Southen neigbour
-    coordinates_t neighbour_south_;
+    //!
+    //! \brief GetHoleIdsOnWayTo Gives ids of holes between node and its
+    //! neighbour in the order ball passes them
+    //! \param to direction
+    //! \return hole ids
+    //!
+    const std::vector <ball_id_t> & GetHoleIdsOnWayTo (Direction to) const;
 
-    //! \brief neighbour_north_ Easten neigbour
-    coordinates_t neighbour_east_;
+    //!
+    //! \brief FirstOpenHole Find first open hole on the way to neighbour
+    //! \param to direction
+    //! \param open_holes set of open holes
+    //! \return id of the hole, INVALID_ID if ball passes all the way
+    //!
+    ball_id_t FirstOpenHole (Direction to, hole_mask_t open_holes) const
+    {
+        hole_mask_t on_way = hole_masks_[static_cast<size_t>(to)] & open_holes;
+        if (on_way == 0)
+        {
+            return INVALID_ID;
+        }
+        if ((on_way & (on_way - 1)) == 0)
+        {
+            // single open hole: no need to know order of the holes
+            return static_cast<ball_id_t>(__builtin_ctzll(on_way)) + 1;
+        }
+        for (auto id : hole_ids_[static_cast<size_t>(to)])
+        {
+            if (on_way & HoleBit(id))
+            {
+                return id;
+            }
+        }
+        return INVALID_ID;
+    }
 
+private:
+    //! \brief neighbours_ neigbours in every direction
+    coordinates_t neighbours_[4];
 
     //! \brief holes on way north between node and its neigbour
     std::vector<coordinates_t> holes_north_;
@@ -100,8 +171,11 @@ private:
     //! \brief holes on way east between node and its neigbour
     std::vector<coordinates_t> holes_east_;
 
-    //! dummy data to keep compiller happy
-    const coordinates_t invalid_coordinates_;
+    //! \brief hole_masks_ holes on way to every direction
+    hole_mask_t hole_masks_[4];
+
+    //! \brief hole_ids_ ids of holes on way to every direction
+    std::vector <ball_id_t> hole_ids_[4];
 
     //! dummy data to keep compiller happy
     const std::vector<coordinates_t> invalid_vector_;
@@ -110,4 +184,7 @@ private:
 std::ostream &
 operator<< (std::ostream & os, const GraphItem & gi);
 
+//! \brief Graph of possible moves: node for every cell of the board
+using move_graph_t = std::map <const coordinates_t, GraphItem>;
+
 #endif //TG_MOVE_GRAPH_H
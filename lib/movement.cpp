@@ -37,24 +37,16 @@ Movement::Movement(Direction to, const Movement &previous_move)
     , start_move_(false)
     , occupied_cells_ (previous_move.GetBallsPositions())
     , holes_state_ (previous_move.GetHoles())
-    , loop_guard_(previous_move.GetLoopGuard())
 {
 
 }
 
-Movement::Movement(const std::map<coordinates_t, ball_id_t> &balls,
-                   const std::map<coordinates_t, ball_id_t> &holes)
+Movement::Movement(const positions_t &balls,
+                   const positions_t &holes)
     : start_move_ (true)
     , occupied_cells_ (balls)
     , holes_state_ (holes)
 {
-    for (auto ball : balls)
-    {
-        LoopGuard lg;
-        lg.visited_cells_[ball.first] = true;
-
-        loop_guard_.insert(std::make_pair(ball.second, lg));
-    }
 }
 
 bool Movement::IsStartMove() const
@@ -66,8 +58,9 @@ bool Movement::SetBallPosition(ball_id_t ball,
                                const coordinates_t & current_cell,
                                const coordinates_t & previous_cell)
 {
+    // previous cell can be already taken by another ball
     auto search = occupied_cells_.find(previous_cell);
-    if (search != occupied_cells_.end())
+    if ((search != occupied_cells_.end()) && (search->second == ball))
     {
         occupied_cells_.erase(search);
     }
@@ -94,13 +87,17 @@ bool Movement::SetBallPosition(ball_id_t ball,
         {
             // just place ball on the cell
             occupied_cells_.insert(std::make_pair(current_cell, ball));
-            loop_guard_.at(ball).visited_cells_[current_cell] = true;
             return true;
         }
     }
     return false;
 }
 
+void Movement::LiftBalls()
+{
+    occupied_cells_.clear();
+}
+
 const coordinates_t Movement::GetBallPosition(ball_id_t ball)
 {
     for (auto i : occupied_cells_)
@@ -118,37 +115,12 @@ Direction Movement::GetMove() const
     return move_;
 }
 
-const std::map<coordinates_t, ball_id_t> &Movement::GetBallsPositions() const
+const positions_t &Movement::GetBallsPositions() const
 {
     return occupied_cells_;
 }
 
-const std::map<coordinates_t, ball_id_t> &Movement::GetHoles() const
+const positions_t &Movement::GetHoles() const
 {
     return holes_state_;
 }
-
-const std::map<ball_id_t, Movement::LoopGuard> Movement::GetLoopGuard() const
-{
-    return loop_guard_;
-}
-
-void Movement::InitLoopGuard()
-{
-    for (auto lg : loop_guard_)
-    {
-        lg.second.visited_cells_count_ = lg.second.visited_cells_.size();
-    }
-}
-
-bool Movement::IsLooped() const
-{
-    for (auto lg : loop_guard_)
-    {
-        if (lg.second.visited_cells_count_ != lg.second.visited_cells_.size())
-        {
-            return false;
-        }
-    }
-    return true;
-}
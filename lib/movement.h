@@ -36,6 +36,14 @@
 #include <map>
 
 #include "tg_types.h"
+#include "arena.h"
+
+//!
+//! \brief Objects positions on the board: cell coordinates and object's id.
+//! Memory is taken from search arena, if any
+//!
+using positions_t = std::map <coordinates_t, ball_id_t, std::less <coordinates_t>,
+                              ArenaAllocator <std::pair <const coordinates_t, ball_id_t> > >;
 
 //!
 //! \brief The Movement class stores state during computing possible movements
@@ -55,8 +63,10 @@ public:
     //! \param balls coordinates of balls and their's ids
     //! \param holes coordinates of holes and their's ids
     //!
-    Movement(const std::map <coordinates_t, ball_id_t> & balls,
-             const std::map <coordinates_t, ball_id_t> & holes);
+    Movement(const positions_t & balls,
+             const positions_t & holes);
+    Movement(const Movement &) = default;
+    Movement(Movement &&) = default;
     ~Movement() = default;
 
     //!
@@ -79,6 +89,14 @@ public:
                          const coordinates_t &current_cell,
                          const coordinates_t &previous_cell);
 
+    //!
+    //! \brief LiftBalls remove all balls from the board before setting their
+    //! new positions with %SetBallPosition(). All balls roll simultaneously,
+    //! so new position of one ball cannot be occupied by previous position
+    //! of another one
+    //!
+    void LiftBalls ();
+
     //!
     //! \brief GetBallPosition Get current position for specific ball
     //! \param ball id of the ball
@@ -98,53 +116,14 @@ public:
     //! reached it's hole it will not be present in in return value
     //! \return current position of all balls
     //!
-    const std::map <coordinates_t, ball_id_t> & GetBallsPositions () const;
+    const positions_t & GetBallsPositions () const;
 
     //!
     //! \brief GetHoles Return current state of all states of all the holes.
     //! If hole is closed by the ball it will not be present in return value;
     //! \return current state of all holes
     //!
-    const std::map <coordinates_t, ball_id_t> & GetHoles () const;
-
-    //!
-    //! \brief The LoopGuard struct Keep track of loops for all the mooves
-    //!
-    struct LoopGuard
-    {
-        //! \brief visited_cells_count_ tracks difference from current
-        //! count of visited cells
-        size_t visited_cells_count_;
-
-        //! \brief visited_cells_ visited cells. each item has value 'true'
-        //! if cell was visited, otherwise corresponding value is not set
-        std::map <coordinates_t, bool> visited_cells_;
-    };
-
-    //!
-    //! \brief GetLoopGuard return current state of loop guard
-    //! \return state of loop guard
-    //!
-    const std::map <ball_id_t, LoopGuard>  GetLoopGuard () const;
-
-    //!
-    //! \brief InitLoopGuard need to be called before using loop guard.
-    //! Call init of loop guard, update current positions of balls and then
-    //! check for loops with %IsLooped()
-    //!
-    void InitLoopGuard ();
-
-    //!
-    //! \brief IsLooped Check if last moves caused game state to be looped.
-    //! First init loop guard by calling  %InitLoopGuard(), update current
-    //! ball positions with %SetBallPosition(). After that safe to use %IsLooped()
-    //! check
-    //!
-    //! If updating ball positions doesnot make balls to visit new cell,
-    //! state just got stack in loop and game will never reach win position
-    //! \return bool true if state was looped
-    //!
-    bool IsLooped () const;
+    const positions_t & GetHoles () const;
 
 
 private:
@@ -163,17 +142,12 @@ private:
     //!
     //! \brief occupied_cells_ Describes current ball positions on this move
     //!
-    std::map <coordinates_t, ball_id_t> occupied_cells_;
+    positions_t occupied_cells_;
 
     //!
     //! \brief holes_state_ Describes open holes on this move
     //!
-    std::map <coordinates_t, ball_id_t> holes_state_;
-
-    //!
-    //! \brief loop_guard_ per-ball loop guard
-    //!
-    std::map <ball_id_t, LoopGuard> loop_guard_;
+    positions_t holes_state_;
 
 };
 
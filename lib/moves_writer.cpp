@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "moves_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+namespace
+{
+
+//! \brief kMoveNames move names in order of %Direction values
+const char kMoveNames[] = {'N', 'W', 'S', 'E'};
+
+} // namespace
+
+const size_t MovesWriter::kDefaultBufferSize;
+
+MovesWriter::MovesWriter(int fd, size_t buffer_size)
+    : fd_(fd)
+    // every move takes two characters, it must fit to the buffer
+    , buffer_(std::max(buffer_size, static_cast<size_t>(2)))
+    , used_(0)
+{
+}
+
+MovesWriter::~MovesWriter()
+{
+    Flush();
+}
+
+bool MovesWriter::Write(const moves_sequence_t &moves)
+{
+    size_t size = moves.size() * 2 + 1;
+    if ((buffer_.size() - used_ < size) && !Flush())
+    {
+        return false;
+    }
+
+    if (size <= buffer_.size())
+    {
+        char * out = buffer_.data() + used_;
+        for (auto move : moves)
+        {
+            out[0] = kMoveNames[static_cast<size_t>(move)];
+            out[1] = ' ';
+            out += 2;
+        }
+        *out++ = '\n';
+        used_ = out - buffer_.data();
+        return true;
+    }
+
+    // sequence doesn't fit even to empty buffer
+    for (auto move : moves)
+    {
+        if ((buffer_.size() - used_ < 2) && !Flush())
+        {
+            return false;
+        }
+        buffer_[used_++] = kMoveNames[static_cast<size_t>(move)];
+        buffer_[used_++] = ' ';
+    }
+    if ((used_ == buffer_.size()) && !Flush())
+    {
+        return false;
+    }
+    buffer_[used_++] = '\n';
+    return true;
+}
+
+bool MovesWriter::Write(const std::list<moves_sequence_t> &moves)
+{
+    for (auto & sequence : moves)
+    {
+        if (!Write(sequence))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MovesWriter::Write(const SolutionGraph &graph)
+{
+    SolutionGraph::Iterator iterator (graph);
+    moves_sequence_t sequence;
+    while (iterator.Next(sequence))
+    {
+        if (!Write(sequence))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MovesWriter::Flush()
+{
+    size_t written = 0;
+    while (written < used_)
+    {
+        ssize_t result = write(fd_, buffer_.data() + written, used_ - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // unwritten data is dropped, writer stays usable
+            used_ = 0;
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    used_ = 0;
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_MOVES_WRITER_H
+#define TG_MOVES_WRITER_H
+
+#include <cstddef>
+#include <list>
+#include <vector>
+
+#include "solution_graph.h"
+#include "tg_types.h"
+
+//!
+//! \brief The MovesWriter class Writes moves sequences to file descriptor in
+//! the same form as %GameTable::PrintMoves(): every move is followed by a
+//! space, every sequence ends with a new line.
+//!
+//! Sequences are formatted to reusable buffer, two characters per move, and
+//! buffer is written by write(2) when it is full. Streams are not used, so
+//! text written to the same descriptor by streams must be flushed before.
+//!
+class MovesWriter
+{
+public:
+    //! \brief kDefaultBufferSize default size of output buffer
+    static const size_t kDefaultBufferSize = 256 * 1024;
+
+    //!
+    //! \brief MovesWriter Create writer. Descriptor is not closed by writer
+    //! \param fd output file descriptor
+    //! \param buffer_size size of output buffer
+    //!
+    explicit MovesWriter (int fd, size_t buffer_size = kDefaultBufferSize);
+
+    //!
+    //! \brief ~MovesWriter write buffered data
+    //!
+    ~MovesWriter ();
+
+    MovesWriter (const MovesWriter &) = delete;
+    MovesWriter & operator= (const MovesWriter &) = delete;
+
+    //!
+    //! \brief Write write one moves sequence
+    //! \param moves moves sequence
+    //! \return false on write error
+    //!
+    bool Write (const moves_sequence_t & moves);
+
+    //!
+    //! \brief Write write moves sequences
+    //! \param moves moves sequences
+    //! \return false on write error
+    //!
+    bool Write (const std::list <moves_sequence_t> & moves);
+
+    //!
+    //! \brief Write expand the graph and write all its sequences. Sequences
+    //! are not kept in memory, see %SolutionGraph::Iterator
+    //! \param graph graph of the best moves sequences
+    //! \return false on write error
+    //!
+    bool Write (const SolutionGraph & graph);
+
+    //!
+    //! \brief Flush write buffered data
+    //! \return false on write error
+    //!
+    bool Flush ();
+
+private:
+    //! \brief fd_ output file descriptor
+    int fd_;
+
+    //! \brief buffer_ output buffer
+    std::vector <char> buffer_;
+
+    //! \brief used_ size of buffered data
+    size_t used_;
+};
+
+#endif // TG_MOVES_WRITER_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "packed_solver.h"
+
+namespace
+{
+
+//!
+//! \brief SolveWith solve the game with packed solver for C rest cells
+//! \return false if game doesn't fit to the solver
+//!
+template <std::uint32_t C>
+bool SolveWith (const RestCells & rest,
+                const HoleOrder & order,
+                const move_graph_t & graph,
+                const std::map <coordinates_t, Ball> & balls,
+                const std::map <ball_id_t, coordinates_t> & holes,
+                size_t max_moves,
+                size_t visited_limit,
+                SolutionGraph & solutions,
+                SearchStats & stats,
+                const std::atomic <bool> * cancel,
+                SearchProgress * progress)
+{
+    if (!PackedSolver<C>::Fits(rest, holes.size()))
+    {
+        return false;
+    }
+
+    PackedSolver<C> solver (rest, graph, balls, holes);
+    solver.SetHoleOrder(order);
+    solver.SetCancelFlag(cancel);
+    solver.SetProgress(progress);
+    solver.Solve(max_moves, visited_limit, solutions, stats);
+    return true;
+}
+
+} // namespace
+
+bool FindAllMovesPacked (const RestCells & rest,
+                         const HoleOrder & order,
+                         const move_graph_t & graph,
+                         const std::map <coordinates_t, Ball> & balls,
+                         const std::map <ball_id_t, coordinates_t> & holes,
+                         size_t max_moves,
+                         size_t visited_limit,
+                         SolutionGraph & solutions,
+                         SearchStats & stats,
+                         const std::atomic <bool> * cancel,
+                         SearchProgress * progress)
+{
+    if (rest.GetCount() <= 64)
+    {
+        return SolveWith<64>(rest, order, graph, balls, holes, max_moves,
+                             visited_limit, solutions, stats, cancel,
+                             progress);
+    }
+    return SolveWith<256>(rest, order, graph, balls, holes, max_moves,
+                          visited_limit, solutions, stats, cancel,
+                          progress);
+}
@@ -0,0 +1,1075 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_PACKED_SOLVER_H
+#define TG_PACKED_SOLVER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "analysis.h"
+#include "ball.h"
+#include "direction_traits.h"
+#include "frontier.h"
+#include "move_graph.h"
+#include "rest_cells.h"
+#include "search_stats.h"
+#include "solution_graph.h"
+#include "state_rank.h"
+#include "tg_types.h"
+#include "tg_utils.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+//!
+//! \brief The PackedSolver class Solver for boards with not more than C
+//! rest cells.
+//!
+//! Only cells where balls can stay are numbered, see %RestCells, so even
+//! big sparse board fits to one byte cell index. The move graph is kept in
+//! fixed size arrays. Whole game state fits to 64-bit word: byte i is the
+//! rest cell of ball i + 1, the highest byte is the set of balls which are
+//! already in their holes. So every state is stored only once and search
+//! stops even if game cannot be won.
+//!
+//! Search is breadth first. Every layer is stored as compressed sorted set
+//! of states and states of previous layers are dropped from the new layer
+//! by single merge pass. Moves are not stored: when final state is found,
+//! layers are tilted once again from the last one to the first to find
+//! states, which lead to the final state by the shortest way. They make
+//! the graph of all the best sequences, see %SolutionGraph.
+//!
+//! States of the layer are tilted by blocks of %kLanes states, see
+//! TiltBlock(). With AVX2 enabled the whole block is rolled by vector
+//! gathers from the dense tilt table.
+//!
+template <std::uint32_t C>
+class PackedSolver
+{
+public:
+    static_assert(C <= 256, "cell index must fit to one byte");
+
+    //! \brief cell_t index of rest cell
+    using cell_t = std::uint8_t;
+
+    //! \brief state_t packed game state
+    using state_t = std::uint64_t;
+
+    //! \brief kCells maximum number of rest cells
+    static constexpr size_t kCells = C;
+
+    //! \brief kMaxBalls maximum number of balls in packed state
+    static constexpr ball_id_t kMaxBalls = 7;
+
+    //! \brief kLanes number of states tilted at once by TiltBlock()
+    static constexpr size_t kLanes = 8;
+
+    //!
+    //! \brief The StateBlock struct Block of packed states stored ball by
+    //! ball: cells of the same ball in all the lanes are adjacent
+    //!
+    struct StateBlock
+    {
+        //! \brief cells cell of every ball in every lane, 0 if ball is removed
+        std::array <std::array <std::uint32_t, kLanes>, kMaxBalls> cells;
+
+        //! \brief removed set of removed balls in every lane
+        std::array <std::uint32_t, kLanes> removed;
+    };
+
+    //!
+    //! \brief Fits check if game can be solved by this solver
+    //! \param rest rest cells of the board
+    //! \param balls_count number of balls
+    //! \return true if game fits
+    //!
+    static bool Fits (const RestCells & rest, size_t balls_count)
+    {
+        return (rest.GetCount() <= kCells) && (balls_count > 0) &&
+               (balls_count <= kMaxBalls);
+    }
+
+    //!
+    //! \brief PackedSolver Prepare the game, it must fit to the solver
+    //! \param rest rest cells of the board
+    //! \param graph move graph of the board
+    //! \param balls initial positions of balls
+    //! \param holes positions of holes
+    //!
+    PackedSolver (const RestCells & rest,
+                  const move_graph_t & graph,
+                  const std::map <coordinates_t, Ball> & balls,
+                  const std::map <ball_id_t, coordinates_t> & holes);
+
+    //!
+    //! \brief GetStartState gives initial state of the game
+    //! \return packed state
+    //!
+    state_t GetStartState () const { return start_; }
+
+    //!
+    //! \brief IsWon check if all balls are in their holes
+    //! \param state packed state
+    //! \return true if game is won
+    //!
+    bool IsWon (state_t state) const { return state == won_; }
+
+    //!
+    //! \brief Tilt roll all balls to the direction
+    //! \param to direction
+    //! \param state state before the tilt
+    //! \param result state after the tilt
+    //! \return false if some ball falls to other's hole
+    //!
+    bool Tilt (Direction to, state_t state, state_t & result) const;
+
+    //!
+    //! \brief TiltBlock roll all balls to the direction in every lane of
+    //! the block. Results are the same as of Tilt() for every lane
+    //! \param to direction
+    //! \param in states before the tilt, filled by Unpack()
+    //! \param count number of used lanes
+    //! \param out states after the tilt, lanes of failed tilts are undefined
+    //! \return failure mask: bit is set for every lane, where some ball falls
+    //! to other's hole
+    //!
+    std::uint32_t TiltBlock (Direction to, const StateBlock & in, size_t count,
+                             StateBlock & out) const;
+
+    //!
+    //! \brief Unpack store packed states to the block, unused lanes are
+    //! filled with zeroes
+    //! \param states packed states
+    //! \param count number of states, not bigger than %kLanes
+    //! \param block block of states
+    //!
+    static void Unpack (const state_t * states, size_t count, StateBlock & block);
+
+    //!
+    //! \brief Pack read packed states from the block
+    //! \param block block of states
+    //! \param count number of states, not bigger than %kLanes
+    //! \param states packed states
+    //!
+    static void Pack (const StateBlock & block, size_t count, state_t * states);
+
+    //!
+    //! \brief SetHoleOrder drop states where some ball cannot reach its hole
+    //! anymore. By default all states are kept
+    //! \param order order of holes closing found for this game
+    //!
+    void SetHoleOrder (const HoleOrder & order);
+
+    //!
+    //! \brief SetCancelFlag stop search when the flag is raised, see
+    //! %GameTable::SetCancelFlag()
+    //! \param cancel cancellation flag, nullptr if search is never cancelled
+    //!
+    void SetCancelFlag (const std::atomic <bool> * cancel) { cancel_ = cancel; }
+
+    //!
+    //! \brief SetProgress publish search progress layer by layer, see
+    //! %GameTable::SetProgress()
+    //! \param progress progress counters, nullptr if not needed
+    //!
+    void SetProgress (SearchProgress * progress) { progress_ = progress; }
+
+    //!
+    //! \brief IsDead check if some ball is in its dead cell
+    //! \param state packed state
+    //! \return true if game cannot be won from the state
+    //!
+    bool IsDead (state_t state) const
+    {
+        std::uint32_t removed = static_cast<std::uint32_t>(state >> kRemovedShift);
+        for (ball_id_t i = 0; i < balls_count_; ++i)
+        {
+            if ((dead_[(state >> (i * 8)) & 0xFF] & ~removed) & (1u << i))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //!
+    //! \brief Solve find all the best moves sequences
+    //! \param max_moves maximum length of sequences, 0 for unlimited
+    //! \param visited_limit memory limit of visited states bitmap. If
+    //! bitmap doesn't fit to it, new layers are compared with previous ones
+    //! \param solutions graph of the best moves sequences, empty if game
+    //! cannot be won or search is cancelled
+    //! \param stats search statistics
+    //!
+    void Solve (size_t max_moves, size_t visited_limit,
+                SolutionGraph & solutions, SearchStats & stats) const;
+
+    //!
+    //! \brief Index gives rest cell index
+    //! \param cell cell coordinates, ball must be able to stay there
+    //! \return cell index
+    //!
+    cell_t Index (const coordinates_t & cell) const
+    {
+        return static_cast<cell_t>(rest_.GetIndex(cell));
+    }
+
+private:
+    //! \brief kRemovedShift position of removed balls set in the state
+    static constexpr unsigned kRemovedShift = 56;
+
+    //! \brief rest_ rest cells of the board
+    RestCells rest_;
+
+    //! \brief balls_count_ number of balls
+    ball_id_t balls_count_;
+
+    //! \brief start_ initial state
+    state_t start_;
+
+    //! \brief won_ final state: all balls are removed
+    state_t won_;
+
+    //! \brief neighbours_ stop cell in every direction
+    std::array <std::array <cell_t, 4>, kCells> neighbours_;
+
+    //! \brief hole_masks_ holes on the way in every direction
+    std::array <std::array <std::uint8_t, 4>, kCells> hole_masks_;
+
+    //! \brief hole_ids_ holes on the way in the order ball meets them
+    std::array <std::array <std::array <std::uint8_t, kMaxBalls>, 4>, kCells> hole_ids_;
+
+    //! \brief dead_ set of balls which cannot reach their holes from
+    //! every cell
+    std::array <std::uint8_t, kCells> dead_;
+
+    //! \brief hole_at_ id of the hole in every cell, INVALID_ID if no hole
+    std::array <std::uint8_t, kCells> hole_at_;
+
+    //! \brief lines_ dense index of the row (0) and the column (1) of
+    //! every cell
+    std::array <std::array <cell_t, 2>, kCells> lines_;
+
+    //! \brief lines_count_ number of rows (0) and columns (1) with rest cells
+    std::array <size_t, 2> lines_count_;
+
+    //! \brief along_ position of every cell along its row (0) and its
+    //! column (1)
+    std::array <std::array <coordinate_t, 2>, kCells> along_;
+
+    //! \brief cancel_ cancellation flag, can be nullptr
+    const std::atomic <bool> * cancel_;
+
+    //! \brief progress_ published search progress, can be nullptr
+    SearchProgress * progress_;
+
+    //! \brief behind_ cell where ball stops behind other ball staying in
+    //! the cell, for every direction
+    std::array <std::array <cell_t, 4>, kCells> behind_;
+
+    //! \brief kRunSize number of raw states of the next layer collected
+    //! before they are compressed
+    static const size_t kRunSize = 1 << 20;
+
+    //! \brief tilt_table_ dense tilt table for every direction: stop cell in
+    //! bits 0-7, holes on the way in bits 8-15 and hole in the stop cell in
+    //! bits 16-23
+    std::array <std::array <std::uint32_t, kCells>, 4> tilt_table_;
+
+    //!
+    //! \brief Tilt roll all balls to direction known at compile time
+    //!
+    template <Direction To>
+    bool Tilt (state_t state, state_t & result) const;
+
+    //!
+    //! \brief TiltBlock roll all balls of the block to direction known at
+    //! compile time
+    //!
+    template <Direction To>
+    std::uint32_t TiltBlock (const StateBlock & in, size_t count,
+                             StateBlock & out) const;
+
+    //!
+    //! \brief Rank gives rank of the state
+    //! \param ranker ranking of packed states
+    //! \param state packed state
+    //! \param cells buffer for cells of all balls
+    //! \return state rank
+    //!
+    std::uint64_t Rank (const StateRanker & ranker, state_t state,
+                        std::vector <std::uint32_t> & cells) const
+    {
+        cells.resize(balls_count_);
+        for (ball_id_t i = 0; i < balls_count_; ++i)
+        {
+            cells[i] = ((state >> (kRemovedShift + i)) & 1) ?
+                        ranker.GetRemovedCell() : ((state >> (i * 8)) & 0xFF);
+        }
+        return ranker.Rank(cells);
+    }
+
+    //!
+    //! \brief RollBlock move every ball to its stop cell, don't care about
+    //! other balls and holes
+    //! \return mask of lanes, where some ball meets open hole or other ball
+    //! and the lane must be tilted again by Tilt()
+    //!
+    std::uint32_t RollBlock (Direction to, const StateBlock & in, size_t count,
+                             StateBlock & out) const;
+
+    //!
+    //! \brief FirstOpenHole find first open hole on the way from the cell
+    //! \param cell start cell
+    //! \param to direction
+    //! \param open_holes set of open holes
+    //! \return hole id, INVALID_ID if ball passes all the way
+    //!
+    ball_id_t FirstOpenHole (cell_t cell, Direction to, std::uint8_t open_holes) const
+    {
+        std::uint8_t on_way = hole_masks_[cell][static_cast<size_t>(to)] & open_holes;
+        if (on_way == 0)
+        {
+            return INVALID_ID;
+        }
+        if ((on_way & (on_way - 1)) == 0)
+        {
+            return static_cast<ball_id_t>(__builtin_ctz(on_way)) + 1;
+        }
+        for (auto id : hole_ids_[cell][static_cast<size_t>(to)])
+        {
+            if (on_way & (1u << (id - 1)))
+            {
+                return id;
+            }
+        }
+        return INVALID_ID;
+    }
+};
+
+//!
+//! \brief FindAllMovesPacked solve the game with the smallest packed solver
+//! it fits to
+//! \param rest rest cells of the board
+//! \param order order of holes closing
+//! \param graph move graph of the board
+//! \param balls initial positions of balls
+//! \param holes positions of holes
+//! \param max_moves maximum length of sequences, 0 for unlimited
+//! \param visited_limit memory limit of visited states bitmap
+//! \param solutions graph of the best moves sequences
+//! \param stats search statistics
+//! \param cancel cancellation flag, nullptr if search is never cancelled
+//! \param progress published search progress, nullptr if not needed
+//! \return false if game doesn't fit to any packed solver
+//!
+bool FindAllMovesPacked (const RestCells & rest,
+                         const HoleOrder & order,
+                         const move_graph_t & graph,
+                         const std::map <coordinates_t, Ball> & balls,
+                         const std::map <ball_id_t, coordinates_t> & holes,
+                         size_t max_moves,
+                         size_t visited_limit,
+                         SolutionGraph & solutions,
+                         SearchStats & stats,
+                         const std::atomic <bool> * cancel = nullptr,
+                         SearchProgress * progress = nullptr);
+
+template <std::uint32_t C>
+constexpr size_t PackedSolver<C>::kCells;
+
+template <std::uint32_t C>
+constexpr ball_id_t PackedSolver<C>::kMaxBalls;
+
+template <std::uint32_t C>
+constexpr size_t PackedSolver<C>::kLanes;
+
+template <std::uint32_t C>
+constexpr unsigned PackedSolver<C>::kRemovedShift;
+
+template <std::uint32_t C>
+PackedSolver<C>::PackedSolver(const RestCells &rest,
+                              const move_graph_t &graph,
+                              const std::map<coordinates_t, Ball> &balls,
+                              const std::map<ball_id_t, coordinates_t> &holes)
+    : rest_(rest)
+    , balls_count_(static_cast<ball_id_t>(holes.size()))
+    , start_(0)
+    , won_(static_cast<state_t>((1u << holes.size()) - 1) << kRemovedShift)
+    , cancel_(nullptr)
+    , progress_(nullptr)
+{
+    for (auto & row : neighbours_)
+    {
+        row.fill(0);
+    }
+    for (auto & row : hole_masks_)
+    {
+        row.fill(0);
+    }
+    hole_at_.fill(INVALID_ID);
+    dead_.fill(0);
+    for (auto & hole : holes)
+    {
+        if (rest_.GetIndex(hole.second) != RestCells::kInvalidIndex)
+        {
+            hole_at_[Index(hole.second)] = static_cast<std::uint8_t>(hole.first);
+        }
+    }
+    for (auto & row : hole_ids_)
+    {
+        for (auto & ids : row)
+        {
+            ids.fill(INVALID_ID);
+        }
+    }
+
+    for (auto & row : behind_)
+    {
+        row.fill(0);
+    }
+    for (auto & row : lines_)
+    {
+        row.fill(0);
+    }
+    for (auto & row : along_)
+    {
+        row.fill(0);
+    }
+
+    // rest cells are numbered row by row, so rows come in order and
+    // columns are numbered when they are met first time
+    std::map <coordinate_t, cell_t> rows;
+    std::map <coordinate_t, cell_t> columns;
+    for (std::uint32_t cell = 0; cell < rest_.GetCount(); ++cell)
+    {
+        const coordinates_t & coordinates = rest_.GetCell(cell);
+        lines_[cell][0] = rows.emplace(coordinates.y, static_cast<cell_t>(rows.size())).first->second;
+        lines_[cell][1] = columns.emplace(coordinates.x, static_cast<cell_t>(columns.size())).first->second;
+        along_[cell][0] = coordinates.x;
+        along_[cell][1] = coordinates.y;
+        for (auto to : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+        {
+            // cell behind is in the board if some ball can stop there
+            std::uint32_t behind = rest_.GetIndex(GetNeighbourCell(coordinates, ReverseDirection(to)));
+            behind_[cell][static_cast<size_t>(to)] = (behind != RestCells::kInvalidIndex) ?
+                        static_cast<cell_t>(behind) : static_cast<cell_t>(cell);
+        }
+    }
+    lines_count_[0] = rows.size();
+    lines_count_[1] = columns.size();
+
+    for (auto & item : graph)
+    {
+        if (rest_.GetIndex(item.first) == RestCells::kInvalidIndex)
+        {
+            continue;
+        }
+        cell_t cell = Index(item.first);
+        for (auto to : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+        {
+            size_t d = static_cast<size_t>(to);
+            neighbours_[cell][d] = Index(item.second.GetNeigbour(to));
+            hole_masks_[cell][d] = static_cast<std::uint8_t>(item.second.GetHoleMask(to));
+
+            auto & ids = item.second.GetHoleIdsOnWayTo(to);
+            for (size_t i = 0; (i < ids.size()) && (i < kMaxBalls); ++i)
+            {
+                hole_ids_[cell][d][i] = static_cast<std::uint8_t>(ids[i]);
+            }
+        }
+    }
+
+    for (size_t d = 0; d < 4; ++d)
+    {
+        for (size_t cell = 0; cell < kCells; ++cell)
+        {
+            cell_t stop = neighbours_[cell][d];
+            std::uint32_t stop_hole = (hole_at_[stop] != INVALID_ID) ?
+                        (1u << (hole_at_[stop] - 1)) : 0;
+            tilt_table_[d][cell] = stop |
+                    (static_cast<std::uint32_t>(hole_masks_[cell][d]) << 8) |
+                    (stop_hole << 16);
+        }
+    }
+
+    for (auto & ball : balls)
+    {
+        start_ |= static_cast<state_t>(Index(ball.first)) << ((ball.second.GetId() - 1) * 8);
+    }
+}
+
+template <std::uint32_t C>
+void PackedSolver<C>::SetHoleOrder(const HoleOrder &order)
+{
+    for (std::uint32_t cell = 0; cell < rest_.GetCount(); ++cell)
+    {
+        dead_[cell] = 0;
+        for (ball_id_t i = 0; i < balls_count_; ++i)
+        {
+            if (order.IsDead(i + 1, cell))
+            {
+                dead_[cell] |= static_cast<std::uint8_t>(1u << i);
+            }
+        }
+    }
+}
+
+template <std::uint32_t C>
+bool PackedSolver<C>::Tilt(Direction to, state_t state, state_t &result) const
+{
+    switch (to)
+    {
+    case Direction::North:
+        return Tilt<Direction::North>(state, result);
+    case Direction::West:
+        return Tilt<Direction::West>(state, result);
+    case Direction::South:
+        return Tilt<Direction::South>(state, result);
+    case Direction::East:
+        return Tilt<Direction::East>(state, result);
+    }
+    return false;
+}
+
+template <std::uint32_t C>
+template <Direction To>
+bool PackedSolver<C>::Tilt(state_t state, state_t &result) const
+{
+    std::uint8_t removed = static_cast<std::uint8_t>(state >> kRemovedShift);
+    std::uint8_t open_holes = static_cast<std::uint8_t>(~removed);
+
+    // Balls roll one after another: in every column from north to south
+    // for North tilt, in every row from west to east for West tilt and
+    // in opposite order for South and East. Row by row cell numbering
+    // gives this order for all the lines at once
+    std::array <std::uint16_t, kMaxBalls> order;
+    size_t count = 0;
+    for (ball_id_t i = 0; i < balls_count_; ++i)
+    {
+        if (removed & (1u << i))
+        {
+            continue;
+        }
+        std::uint16_t key = static_cast<std::uint16_t>(((state >> (i * 8)) & 0xFF) << 3 | i);
+        size_t j = count++;
+        for (; (j > 0) && ((DirectionTraits<To>::kStep < 0) ? (order[j - 1] > key)
+                                                            : (order[j - 1] < key)); --j)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = key;
+    }
+
+    // last stop in every line
+    const size_t kAxis = DirectionTraits<To>::kVertical ? 1 : 0;
+    std::array <int, kCells> line_stops;
+    std::fill_n(line_stops.begin(), lines_count_[kAxis], -1);
+
+    result = state;
+    for (size_t i = 0; i < count; ++i)
+    {
+        cell_t cell = static_cast<cell_t>(order[i] >> 3);
+        ball_id_t ball = (order[i] & 7) + 1;
+        unsigned shift = (ball - 1) * 8;
+
+        ball_id_t hole = FirstOpenHole(cell, To, open_holes);
+        if (hole != INVALID_ID)
+        {
+            if (hole != ball)
+            {
+                return false;
+            }
+            open_holes &= static_cast<std::uint8_t>(~(1u << (ball - 1)));
+            removed |= static_cast<std::uint8_t>(1u << (ball - 1));
+            result &= ~(static_cast<state_t>(0xFF) << shift);
+            continue;
+        }
+
+        int next = neighbours_[cell][static_cast<size_t>(To)];
+        int & line_stop = line_stops[lines_[cell][kAxis]];
+        if (line_stop >= 0)
+        {
+            coordinate_t position = along_[next][kAxis];
+            coordinate_t stop = along_[line_stop][kAxis];
+            if ((DirectionTraits<To>::kStep < 0) ? (position <= stop) : (position >= stop))
+            {
+                // stand right behind the last ball in the line
+                next = behind_[line_stop][static_cast<size_t>(To)];
+            }
+        }
+        line_stop = next;
+
+        result = (result & ~(static_cast<state_t>(0xFF) << shift)) |
+                 (static_cast<state_t>(next) << shift);
+    }
+
+    // Ball can stop right on the hole, which is not on the way in move
+    // graph: move graph doesn't check the cell ball starts from. Such ball
+    // falls if the hole is its own one, otherwise game is lost
+    for (size_t i = 0; i < count; ++i)
+    {
+        ball_id_t ball = (order[i] & 7) + 1;
+        unsigned shift = (ball - 1) * 8;
+        if (removed & (1u << (ball - 1)))
+        {
+            continue;
+        }
+
+        ball_id_t hole = hole_at_[(result >> shift) & 0xFF];
+        if ((hole == INVALID_ID) || !(open_holes & (1u << (hole - 1))))
+        {
+            continue;
+        }
+        if (hole != ball)
+        {
+            return false;
+        }
+        open_holes &= static_cast<std::uint8_t>(~(1u << (ball - 1)));
+        removed |= static_cast<std::uint8_t>(1u << (ball - 1));
+        result &= ~(static_cast<state_t>(0xFF) << shift);
+    }
+
+    result = (result & ~(static_cast<state_t>(0xFF) << kRemovedShift)) |
+             (static_cast<state_t>(removed) << kRemovedShift);
+    return true;
+}
+
+template <std::uint32_t C>
+void PackedSolver<C>::Unpack(const state_t *states, size_t count, StateBlock &block)
+{
+    for (size_t lane = 0; lane < kLanes; ++lane)
+    {
+        state_t state = (lane < count) ? states[lane] : 0;
+        for (ball_id_t ball = 0; ball < kMaxBalls; ++ball)
+        {
+            block.cells[ball][lane] = (state >> (ball * 8)) & 0xFF;
+        }
+        block.removed[lane] = static_cast<std::uint32_t>(state >> kRemovedShift);
+    }
+}
+
+template <std::uint32_t C>
+void PackedSolver<C>::Pack(const StateBlock &block, size_t count, state_t *states)
+{
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        state_t state = static_cast<state_t>(block.removed[lane]) << kRemovedShift;
+        for (ball_id_t ball = 0; ball < kMaxBalls; ++ball)
+        {
+            state |= static_cast<state_t>(block.cells[ball][lane]) << (ball * 8);
+        }
+        states[lane] = state;
+    }
+}
+
+template <std::uint32_t C>
+std::uint32_t PackedSolver<C>::TiltBlock(Direction to, const StateBlock &in,
+                                         size_t count, StateBlock &out) const
+{
+    switch (to)
+    {
+    case Direction::North:
+        return TiltBlock<Direction::North>(in, count, out);
+    case Direction::West:
+        return TiltBlock<Direction::West>(in, count, out);
+    case Direction::South:
+        return TiltBlock<Direction::South>(in, count, out);
+    case Direction::East:
+        return TiltBlock<Direction::East>(in, count, out);
+    }
+    return (1u << count) - 1;
+}
+
+template <std::uint32_t C>
+template <Direction To>
+std::uint32_t PackedSolver<C>::TiltBlock(const StateBlock &in, size_t count,
+                                         StateBlock &out) const
+{
+    // Usually balls don't meet each other or holes, then every ball
+    // simply rolls to its stop cell. Other lanes are tilted one by one
+    for (ball_id_t ball = balls_count_; ball < kMaxBalls; ++ball)
+    {
+        out.cells[ball].fill(0);
+    }
+    std::uint32_t slow = RollBlock(To, in, count, out);
+    std::uint32_t failures = 0;
+    while (slow != 0)
+    {
+        size_t lane = static_cast<size_t>(__builtin_ctz(slow));
+        slow &= slow - 1;
+
+        state_t state = static_cast<state_t>(in.removed[lane]) << kRemovedShift;
+        for (ball_id_t ball = 0; ball < kMaxBalls; ++ball)
+        {
+            state |= static_cast<state_t>(in.cells[ball][lane]) << (ball * 8);
+        }
+
+        state_t result;
+        if (!Tilt<To>(state, result))
+        {
+            failures |= 1u << lane;
+            continue;
+        }
+        for (ball_id_t ball = 0; ball < kMaxBalls; ++ball)
+        {
+            out.cells[ball][lane] = (result >> (ball * 8)) & 0xFF;
+        }
+        out.removed[lane] = static_cast<std::uint32_t>(result >> kRemovedShift);
+    }
+    return failures;
+}
+
+#ifdef __AVX2__
+
+template <std::uint32_t C>
+std::uint32_t PackedSolver<C>::RollBlock(Direction to, const StateBlock &in,
+                                         size_t count, StateBlock &out) const
+{
+    static_assert(kLanes == 8, "block must fit to one AVX2 register");
+
+    const int * table = reinterpret_cast<const int *>(tilt_table_[static_cast<size_t>(to)].data());
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m256i used = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count)),
+                                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    __m256i removed = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in.removed.data()));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.removed.data()), removed);
+    __m256i open = _mm256_andnot_si256(removed, byte);
+
+    __m256i hazard = zero;
+    __m256i stops[kMaxBalls];
+    __m256i active[kMaxBalls];
+    for (ball_id_t ball = 0; ball < balls_count_; ++ball)
+    {
+        __m256i bit = _mm256_set1_epi32(1 << ball);
+        active[ball] = _mm256_and_si256(used, _mm256_cmpeq_epi32(_mm256_and_si256(open, bit), bit));
+
+        __m256i cells = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in.cells[ball].data()));
+        __m256i entry = _mm256_mask_i32gather_epi32(zero, table, cells, active[ball], 4);
+        stops[ball] = _mm256_and_si256(entry, byte);
+
+        // open hole on the way or in the stop cell
+        __m256i holes = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi32(entry, 8),
+                                                         _mm256_srli_epi32(entry, 16)), open);
+        hazard = _mm256_or_si256(hazard, _mm256_andnot_si256(_mm256_cmpeq_epi32(holes, zero),
+                                                             active[ball]));
+
+        // two balls in the same stop cell are in the same line
+        for (ball_id_t other = 0; other < ball; ++other)
+        {
+            __m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(stops[ball], stops[other]),
+                                            _mm256_and_si256(active[ball], active[other]));
+            hazard = _mm256_or_si256(hazard, same);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.cells[ball].data()), stops[ball]);
+    }
+
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hazard)));
+}
+
+#else
+
+template <std::uint32_t C>
+std::uint32_t PackedSolver<C>::RollBlock(Direction to, const StateBlock &in,
+                                         size_t count, StateBlock &out) const
+{
+    const auto & table = tilt_table_[static_cast<size_t>(to)];
+    std::uint32_t hazard = 0;
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        std::uint32_t open = ~in.removed[lane] & 0xFF;
+        out.removed[lane] = in.removed[lane];
+        for (ball_id_t ball = 0; ball < balls_count_; ++ball)
+        {
+            if (!(open & (1u << ball)))
+            {
+                out.cells[ball][lane] = 0;
+                continue;
+            }
+
+            std::uint32_t entry = table[in.cells[ball][lane]];
+            std::uint32_t stop = entry & 0xFF;
+
+            // open hole on the way or in the stop cell
+            if (((entry >> 8) | (entry >> 16)) & open)
+            {
+                hazard |= 1u << lane;
+            }
+            // two balls in the same stop cell are in the same line
+            for (ball_id_t other = 0; other < ball; ++other)
+            {
+                if ((open & (1u << other)) && (out.cells[other][lane] == stop))
+                {
+                    hazard |= 1u << lane;
+                }
+            }
+            out.cells[ball][lane] = stop;
+        }
+    }
+    return hazard;
+}
+
+#endif // __AVX2__
+
+template <std::uint32_t C>
+void PackedSolver<C>::Solve(size_t max_moves, size_t visited_limit,
+                            SolutionGraph &solutions,
+                            SearchStats &stats) const
+{
+    std::vector <CompressedFrontier> layers (1);
+    std::vector <state_t> raw {start_};
+    layers[0].Assign(raw);
+    stats.CountGenerated(0);
+
+    // Small states space is tracked by bitmap, then new states are
+    // filtered right when they are generated
+    StateRanker ranker (rest_.GetCount(), balls_count_);
+    VisitedStates visited;
+    std::vector <std::uint32_t> cells;
+    if (visited.Reset(ranker.GetSpaceSize(), 1, visited_limit))
+    {
+        visited.Visit(Rank(ranker, start_, cells));
+        stats.visited_bytes = visited.GetBytes();
+    }
+
+    size_t depth = 0;
+    size_t peak_raw = 0;
+    bool won = IsWon(start_);
+
+    while ((layers[depth].GetSize() != 0) && !won &&
+           ((max_moves == 0) || (depth < max_moves)))
+    {
+        const CompressedFrontier & layer = layers[depth];
+        stats.peak_frontier = std::max(stats.peak_frontier, layer.GetSize());
+        stats.CountExpanded(depth, layer.GetSize());
+        if (progress_ != nullptr)
+        {
+            progress_->depth.store(depth, std::memory_order_relaxed);
+            progress_->expanded.fetch_add(layer.GetSize(), std::memory_order_relaxed);
+        }
+
+        // raw states are compressed by runs to keep memory bounded
+        CompressedFrontier next;
+        raw.clear();
+
+        CompressedFrontier::Reader reader (layer);
+        std::array <state_t, kLanes> current;
+        std::array <state_t, kLanes> tilted;
+        StateBlock block;
+        StateBlock result;
+        size_t count;
+        do
+        {
+            if ((cancel_ != nullptr) && cancel_->load(std::memory_order_relaxed))
+            {
+                stats.cancelled = true;
+                break;
+            }
+            for (count = 0; (count < kLanes) && reader.Next(current[count]); ++count)
+            {
+            }
+            if (count == 0)
+            {
+                break;
+            }
+            Unpack(current.data(), count, block);
+
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                std::uint32_t failures = TiltBlock(to, block, count, result);
+                Pack(result, count, tilted.data());
+                for (size_t lane = 0; lane < count; ++lane)
+                {
+                    if (failures & (1u << lane))
+                    {
+                        ++stats.wrong_hole_failures;
+                    }
+                    else if (tilted[lane] == current[lane])
+                    {
+                        ++stats.duplicate_rejections;
+                    }
+                    else if (IsDead(tilted[lane]))
+                    {
+                        ++stats.dead_rejections;
+                    }
+                    else if (visited.IsEnabled() &&
+                             !visited.Visit(Rank(ranker, tilted[lane], cells)))
+                    {
+                        ++stats.visited_rejections;
+                    }
+                    else
+                    {
+                        raw.push_back(tilted[lane]);
+                    }
+                }
+            }
+
+            if (raw.size() >= kRunSize)
+            {
+                peak_raw = std::max(peak_raw, raw.capacity());
+                CompressedFrontier run;
+                run.Assign(raw);
+                next = CompressedFrontier::Merge(next, run);
+                raw.clear();
+            }
+        }
+        while (count == kLanes);
+        if (stats.cancelled)
+        {
+            break;
+        }
+
+        peak_raw = std::max(peak_raw, raw.capacity());
+        CompressedFrontier run;
+        run.Assign(raw);
+        next = CompressedFrontier::Merge(next, run);
+
+        // drop states already reached by shorter moves sequences
+        if (visited.IsEnabled())
+        {
+            layers.push_back(std::move(next));
+        }
+        else
+        {
+            layers.push_back(CompressedFrontier::Difference(next, layers));
+        }
+        ++depth;
+        if (layers[depth].GetSize() != 0)
+        {
+            stats.CountGenerated(depth, layers[depth].GetSize());
+        }
+        won = layers[depth].Contains(won_);
+    }
+
+    stats.peak_bytes_in_use = peak_raw * sizeof(state_t) + visited.GetBytes();
+    stats.peak_bytes_reserved = peak_raw * sizeof(state_t) + visited.GetBytes();
+    for (auto & layer : layers)
+    {
+        stats.peak_bytes_in_use += layer.GetBytes();
+        stats.peak_bytes_reserved += layer.GetReservedBytes();
+    }
+
+    solutions.Clear();
+    if (!won || stats.cancelled)
+    {
+        return;
+    }
+
+    //! move from the state of one layer to the state of the next one
+    struct Step
+    {
+        state_t from;   //!< state before the move
+        Direction to;   //!< move direction
+        state_t next;   //!< state after the move
+    };
+
+    // go back from the final state and keep states, which lead to it
+    std::vector <std::vector <Step> > steps (depth);
+    std::vector <std::vector <state_t> > kept (depth + 1);
+    kept[depth].push_back(won_);
+    for (size_t k = depth; k-- > 0; )
+    {
+        if ((cancel_ != nullptr) && cancel_->load(std::memory_order_relaxed))
+        {
+            stats.cancelled = true;
+            return;
+        }
+        const std::vector <state_t> & targets = kept[k + 1];
+        std::vector <state_t> & sources = kept[k];
+        CompressedFrontier::Reader reader (layers[k]);
+        std::array <state_t, kLanes> current;
+        std::array <state_t, kLanes> tilted;
+        StateBlock block;
+        StateBlock result;
+        size_t count;
+        do
+        {
+            for (count = 0; (count < kLanes) && reader.Next(current[count]); ++count)
+            {
+            }
+            Unpack(current.data(), count, block);
+
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                std::uint32_t failures = TiltBlock(to, block, count, result);
+                Pack(result, count, tilted.data());
+                for (size_t lane = 0; lane < count; ++lane)
+                {
+                    if (!(failures & (1u << lane)) &&
+                        std::binary_search(targets.begin(), targets.end(), tilted[lane]))
+                    {
+                        steps[k].push_back({current[lane], to, tilted[lane]});
+                        sources.push_back(current[lane]);
+                    }
+                }
+            }
+        }
+        while (count == kLanes);
+
+        std::sort(sources.begin(), sources.end());
+        sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    }
+
+    // kept states are numbered by their order in the layer
+    std::vector <std::vector <SolutionGraph::Edge> > edges (depth);
+    for (size_t k = 0; k < depth; ++k)
+    {
+        edges[k].reserve(steps[k].size());
+        for (auto & step : steps[k])
+        {
+            auto from = std::lower_bound(kept[k].begin(), kept[k].end(), step.from);
+            auto next = std::lower_bound(kept[k + 1].begin(), kept[k + 1].end(),
+                                         step.next);
+            edges[k].push_back({static_cast<std::uint32_t>(from - kept[k].begin()),
+                                step.to,
+                                static_cast<std::uint32_t>(next - kept[k + 1].begin())});
+        }
+        std::vector <Step> ().swap(steps[k]);
+    }
+    solutions.Assign(std::move(edges));
+}
+
+#endif // TG_PACKED_SOLVER_H
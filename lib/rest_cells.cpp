@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "rest_cells.h"
+
+#include <cstdint>
+
+#include "tg_utils.h"
+
+const std::uint32_t RestCells::kInvalidIndex;
+
+RestCells::RestCells(coordinate_t table_size, const move_graph_t &graph,
+                     const std::vector<coordinates_t> &starts)
+    : table_size_(table_size)
+    , indices_(static_cast<size_t>(table_size) * table_size, kInvalidIndex)
+{
+    // minimal number of other balls needed to stop ball in the cell
+    const size_t kNotRest = SIZE_MAX;
+    std::vector <size_t> stack (indices_.size(), kNotRest);
+    std::vector <coordinates_t> found;
+    for (auto & cell : starts)
+    {
+        if (stack[BoardIndex(cell)] == kNotRest)
+        {
+            found.push_back(cell);
+        }
+        stack[BoardIndex(cell)] = 0;
+    }
+
+    // Ball rolls from rest cell to the stop point, but it can be stopped
+    // earlier right behind other ball staying in some rest cell on the way.
+    // New rest cells can stop balls from cells already checked, so repeat
+    // until nothing changes
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                const coordinates_t & stop = graph.at(found[i]).GetNeigbour(to);
+                if (stack[BoardIndex(stop)] != 0)
+                {
+                    if (stack[BoardIndex(stop)] == kNotRest)
+                    {
+                        found.push_back(stop);
+                    }
+                    stack[BoardIndex(stop)] = 0;
+                    changed = true;
+                }
+
+                for (coordinates_t cell = found[i]; cell != stop; )
+                {
+                    coordinates_t next = GetNeighbourCell(cell, to);
+                    size_t behind = stack[BoardIndex(next)];
+                    if ((behind != kNotRest) && (behind + 2 <= starts.size()) &&
+                        ((stack[BoardIndex(cell)] == kNotRest) ||
+                         (stack[BoardIndex(cell)] > behind + 1)))
+                    {
+                        if (stack[BoardIndex(cell)] == kNotRest)
+                        {
+                            found.push_back(cell);
+                        }
+                        stack[BoardIndex(cell)] = behind + 1;
+                        changed = true;
+                    }
+                    cell = next;
+                }
+            }
+        }
+    }
+
+    for (coordinate_t y = 1; y <= table_size_; ++y)
+    {
+        for (coordinate_t x = 1; x <= table_size_; ++x)
+        {
+            coordinates_t cell (x, y);
+            if (stack[BoardIndex(cell)] != kNotRest)
+            {
+                indices_[BoardIndex(cell)] = static_cast<std::uint32_t>(cells_.size());
+                cells_.push_back(cell);
+            }
+        }
+    }
+}
+
+std::uint32_t RestCells::GetCount() const
+{
+    return static_cast<std::uint32_t>(cells_.size());
+}
+
+std::uint32_t RestCells::GetIndex(const coordinates_t &cell) const
+{
+    if ((cell.x == 0) || (cell.y == 0) ||
+        (cell.x > table_size_) || (cell.y > table_size_))
+    {
+        return kInvalidIndex;
+    }
+    return indices_[BoardIndex(cell)];
+}
+
+const coordinates_t & RestCells::GetCell(std::uint32_t index) const
+{
+    return cells_[index];
+}
+
+size_t RestCells::BoardIndex(const coordinates_t &cell) const
+{
+    return static_cast<size_t>(cell.y - 1) * table_size_ + (cell.x - 1);
+}
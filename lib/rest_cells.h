@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_REST_CELLS_H
+#define TG_REST_CELLS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "move_graph.h"
+#include "tg_types.h"
+
+//!
+//! \brief The RestCells class Cells where balls can ever stay between moves.
+//!
+//! Ball stops at the wall, at the stop point of the move graph, or right
+//! behind other staying ball. So starting from the initial balls positions
+//! only a small part of big sparse board is ever occupied. Such cells are
+//! numbered densely row by row, so search states can keep small indices
+//! instead of board coordinates.
+//!
+class RestCells
+{
+public:
+    //! \brief kInvalidIndex index of cells, where ball can never stay
+    static const std::uint32_t kInvalidIndex = UINT32_MAX;
+
+    //!
+    //! \brief RestCells Find closure of rest cells
+    //! \param table_size size of the board
+    //! \param graph move graph of the board
+    //! \param starts initial balls positions
+    //!
+    RestCells (coordinate_t table_size, const move_graph_t & graph,
+               const std::vector <coordinates_t> & starts);
+
+    //!
+    //! \brief GetCount number of rest cells
+    //! \return cells count
+    //!
+    std::uint32_t GetCount () const;
+
+    //!
+    //! \brief GetIndex gives dense index of the cell
+    //! \param cell cell coordinates
+    //! \return index, %kInvalidIndex if ball never stays in the cell
+    //!
+    std::uint32_t GetIndex (const coordinates_t & cell) const;
+
+    //!
+    //! \brief GetCell gives cell by its dense index
+    //! \param index index of rest cell
+    //! \return cell coordinates
+    //!
+    const coordinates_t & GetCell (std::uint32_t index) const;
+
+private:
+    //! \brief table_size_ size of the board
+    coordinate_t table_size_;
+
+    //! \brief indices_ dense index of every board cell, row by row
+    std::vector <std::uint32_t> indices_;
+
+    //! \brief cells_ rest cells in order of their indices
+    std::vector <coordinates_t> cells_;
+
+    //!
+    //! \brief BoardIndex gives index of the cell in the whole board
+    //! \param cell cell coordinates
+    //! \return index
+    //!
+    size_t BoardIndex (const coordinates_t & cell) const;
+};
+
+#endif // TG_REST_CELLS_H
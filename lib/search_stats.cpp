@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "search_stats.h"
+
+#include <numeric>
+
+namespace
+{
+
+//!
+//! \brief CountAtDepth increase per-depth counter
+//! \param counters per-depth counters
+//! \param depth depth to be counted
+//! \param count value to be added
+//!
+void CountAtDepth (std::vector <size_t> & counters, size_t depth, size_t count)
+{
+    if (counters.size() <= depth)
+    {
+        counters.resize(depth + 1, 0);
+    }
+    counters[depth] += count;
+}
+
+//!
+//! \brief PrintList print per-depth counters separated by commas
+//! \param os output stream
+//! \param counters per-depth counters
+//!
+void PrintList (std::ostream & os, const std::vector <size_t> & counters)
+{
+    for (size_t i = 0; i < counters.size(); ++i)
+    {
+        os << ((i != 0) ? "," : "") << counters[i];
+    }
+}
+
+} // namespace
+
+std::ostream &
+operator<< (std::ostream & os, SearchMethod method)
+{
+    switch (method)
+    {
+    case SearchMethod::Auto:
+        os << "auto";
+        break;
+    case SearchMethod::Generic:
+        os << "generic";
+        break;
+    case SearchMethod::Packed:
+        os << "packed";
+        break;
+    case SearchMethod::Deepening:
+        os << "deepening";
+        break;
+    case SearchMethod::Portfolio:
+        os << "portfolio";
+        break;
+    }
+    return os;
+}
+
+SearchStats::SearchStats()
+{
+    Reset();
+}
+
+void SearchStats::Reset()
+{
+    from_cache = false;
+    unsolvability = Unsolvability::None;
+    warm_bound = 0;
+    approximate = false;
+    rollouts = 0;
+    cancelled = false;
+    winner = SearchMethod::Auto;
+    frozen_balls = 0;
+    hole_dependencies = 0;
+    generated_by_depth.clear();
+    expanded_by_depth.clear();
+    duplicate_rejections = 0;
+    visited_rejections = 0;
+    dead_rejections = 0;
+    collision_rejections = 0;
+    wrong_hole_failures = 0;
+    tilt_cache_hits = 0;
+    tilt_cache_misses = 0;
+    peak_frontier = 0;
+    peak_bytes_reserved = 0;
+    peak_bytes_in_use = 0;
+    visited_bytes = 0;
+    build_graph_us = 0;
+    search_us = 0;
+}
+
+void SearchStats::Add(const SearchStats &other)
+{
+    rollouts += other.rollouts;
+    for (size_t i = 0; i < other.generated_by_depth.size(); ++i)
+    {
+        CountGenerated(i, other.generated_by_depth[i]);
+    }
+    for (size_t i = 0; i < other.expanded_by_depth.size(); ++i)
+    {
+        CountExpanded(i, other.expanded_by_depth[i]);
+    }
+    duplicate_rejections += other.duplicate_rejections;
+    visited_rejections += other.visited_rejections;
+    dead_rejections += other.dead_rejections;
+    collision_rejections += other.collision_rejections;
+    wrong_hole_failures += other.wrong_hole_failures;
+    tilt_cache_hits += other.tilt_cache_hits;
+    tilt_cache_misses += other.tilt_cache_misses;
+    peak_frontier += other.peak_frontier;
+    peak_bytes_reserved += other.peak_bytes_reserved;
+    peak_bytes_in_use += other.peak_bytes_in_use;
+    visited_bytes += other.visited_bytes;
+}
+
+void SearchStats::CountGenerated(size_t depth, size_t count)
+{
+    CountAtDepth(generated_by_depth, depth, count);
+}
+
+void SearchStats::CountExpanded(size_t depth, size_t count)
+{
+    CountAtDepth(expanded_by_depth, depth, count);
+}
+
+size_t SearchStats::GetGenerated() const
+{
+    return std::accumulate(generated_by_depth.begin(),
+                           generated_by_depth.end(), size_t(0));
+}
+
+size_t SearchStats::GetExpanded() const
+{
+    return std::accumulate(expanded_by_depth.begin(),
+                           expanded_by_depth.end(), size_t(0));
+}
+
+double SearchStats::GetTiltCacheHitRate() const
+{
+    size_t lookups = tilt_cache_hits + tilt_cache_misses;
+    return (lookups != 0) ? static_cast<double>(tilt_cache_hits) / lookups : 0;
+}
+
+std::ostream &
+operator<< (std::ostream & os, const SearchStats & stats)
+{
+    os << "cached="           << (stats.from_cache ? 1 : 0)
+       << " build_graph_us="  << stats.build_graph_us
+       << " search_us="       << stats.search_us
+       << " unsolvable="      << stats.unsolvability
+       << " warm_bound="      << stats.warm_bound
+       << " approximate="     << (stats.approximate ? 1 : 0)
+       << " rollouts="        << stats.rollouts
+       << " cancelled="       << (stats.cancelled ? 1 : 0)
+       << " winner="          << stats.winner
+       << " frozen="          << stats.frozen_balls
+       << " dependencies="    << stats.hole_dependencies
+       << " generated="       << stats.GetGenerated()
+       << " expanded="        << stats.GetExpanded()
+       << " duplicates="      << stats.duplicate_rejections
+       << " visited="         << stats.visited_rejections
+       << " dead="            << stats.dead_rejections
+       << " collisions="      << stats.collision_rejections
+       << " wrong_holes="     << stats.wrong_hole_failures
+       << " tilt_hits="       << stats.tilt_cache_hits
+       << " tilt_misses="     << stats.tilt_cache_misses
+       << " tilt_hit_rate="   << stats.GetTiltCacheHitRate()
+       << " peak_frontier="   << stats.peak_frontier
+       << " peak_bytes="      << stats.peak_bytes_reserved
+       << " peak_bytes_used=" << stats.peak_bytes_in_use
+       << " visited_bytes="   << stats.visited_bytes
+       << " generated_by_depth=";
+    PrintList(os, stats.generated_by_depth);
+    os << " expanded_by_depth=";
+    PrintList(os, stats.expanded_by_depth);
+    return os;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SEARCH_STATS_H
+#define TG_SEARCH_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <ostream>
+
+#include "analysis.h"
+
+//!
+//! \brief The SearchMethod enum How %GameTable looks for the best moves
+//!
+enum class SearchMethod
+{
+    Auto,       //!< packed search if game fits to it, generic otherwise
+    Generic,    //!< search over board coordinates, works for any game
+    Packed,     //!< packed search for small boards, generic if game doesn't fit
+    Deepening,  //!< iterative deepening depth first search over board
+                //!< coordinates, keeps only current moves sequence
+    Portfolio   //!< all the methods race in parallel, first one wins
+};
+
+std::ostream &
+operator<< (std::ostream & os, SearchMethod method);
+
+//!
+//! \brief The SearchProgress struct Progress of running search, which can
+//! be polled from other thread, see %GameTable::SetProgress()
+//!
+struct SearchProgress
+{
+    //! \brief depth depth being expanded
+    std::atomic <size_t> depth;
+
+    //! \brief expanded number of states expanded so far
+    std::atomic <size_t> expanded;
+
+    SearchProgress () : depth(0), expanded(0) {}
+};
+
+//!
+//! \brief The SearchStats struct Counters collected during one
+//! %GameTable::CalculateMoves() call
+//!
+struct SearchStats
+{
+    //! \brief from_cache true if solutions were taken from solutions cache
+    bool from_cache;
+
+    //! \brief unsolvability reason why game cannot be won found before
+    //! search, search is not done if there is any
+    Unsolvability unsolvability;
+
+    //! \brief warm_bound length of previous best solution, which still
+    //! wins the game, 0 if there is no such solution
+    size_t warm_bound;
+
+    //! \brief approximate true if moves were found by approximate search
+    //! and may be not the shortest ones
+    bool approximate;
+
+    //! \brief rollouts number of finished approximate searches
+    size_t rollouts;
+
+    //! \brief cancelled true if search was cancelled, no moves are found
+    //! then
+    bool cancelled;
+
+    //! \brief winner method which found the moves first, see
+    //! %SearchMethod::Portfolio. Auto if methods didn't race
+    SearchMethod winner;
+
+    //! \brief frozen_balls number of balls which can never move
+    size_t frozen_balls;
+
+    //! \brief hole_dependencies number of pairs of balls, where one ball
+    //! must drop to its hole before the other one
+    size_t hole_dependencies;
+
+    //! \brief generated_by_depth number of new states for every depth
+    std::vector <size_t> generated_by_depth;
+
+    //! \brief expanded_by_depth number of states, which were tried to be
+    //! moved in all directions, for every depth
+    std::vector <size_t> expanded_by_depth;
+
+    //! \brief duplicate_rejections moves that don't change the state
+    size_t duplicate_rejections;
+
+    //! \brief visited_rejections moves to states already reached by
+    //! shorter moves sequences
+    size_t visited_rejections;
+
+    //! \brief dead_rejections moves leaving some ball where it cannot
+    //! reach its hole from
+    size_t dead_rejections;
+
+    //! \brief collision_rejections moves where balls cannot be placed
+    //! to their new cells
+    size_t collision_rejections;
+
+    //! \brief wrong_hole_failures moves where some ball falls to other's hole
+    size_t wrong_hole_failures;
+
+    //! \brief tilt_cache_hits tilts which results were found in tilt cache
+    size_t tilt_cache_hits;
+
+    //! \brief tilt_cache_misses tilts which were computed
+    size_t tilt_cache_misses;
+
+    //! \brief peak_frontier maximum number of states waiting to be expanded
+    size_t peak_frontier;
+
+    //! \brief peak_bytes_reserved peak size of memory reserved for search
+    size_t peak_bytes_reserved;
+
+    //! \brief peak_bytes_in_use peak size of memory used by search
+    size_t peak_bytes_in_use;
+
+    //! \brief visited_bytes size of visited states bitmap, 0 if visited
+    //! states are not tracked by rank
+    size_t visited_bytes;
+
+    //! \brief build_graph_us time spent building move graph, microseconds
+    std::uint64_t build_graph_us;
+
+    //! \brief search_us time spent searching best moves, microseconds
+    std::uint64_t search_us;
+
+    SearchStats ();
+
+    //!
+    //! \brief Reset set all counters to zero
+    //!
+    void Reset ();
+
+    //!
+    //! \brief Add add counters of other search. Peak values are summed too,
+    //! since searches are supposed to run at the same time
+    //! \param other statistics of other search
+    //!
+    void Add (const SearchStats & other);
+
+    //!
+    //! \brief CountGenerated count new states
+    //! \param depth depth of the states
+    //! \param count number of states
+    //!
+    void CountGenerated (size_t depth, size_t count = 1);
+
+    //!
+    //! \brief CountExpanded count expanded states
+    //! \param depth depth of the states
+    //! \param count number of states
+    //!
+    void CountExpanded (size_t depth, size_t count = 1);
+
+    //!
+    //! \brief GetGenerated total number of generated states
+    //! \return states count
+    //!
+    size_t GetGenerated () const;
+
+    //!
+    //! \brief GetExpanded total number of expanded states
+    //! \return states count
+    //!
+    size_t GetExpanded () const;
+
+    //!
+    //! \brief GetTiltCacheHitRate part of tilts found in tilt cache
+    //! \return hit rate from 0 to 1
+    //!
+    double GetTiltCacheHitRate () const;
+};
+
+//!
+//! \brief operator << print statistics as single line of key=value pairs.
+//! Per-depth counters are printed as comma separated lists
+//! \param os output stream
+//! \param stats search statistics
+//! \return output stream
+//!
+std::ostream &
+operator<< (std::ostream & os, const SearchStats & stats);
+
+#endif // TG_SEARCH_STATS_H
@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solution_cache.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+//! \brief kMagic cache file signature
+const char kMagic[8] = {'T', 'G', 'C', 'A', 'C', 'H', 'E', '2'};
+
+//! \brief kMinimalMapSize size of newly created cache file
+const size_t kMinimalMapSize = 64 * 1024;
+
+//! \brief kEndOfSequence marks end of every stored moves sequence
+const std::uint8_t kEndOfSequence = 0xFF;
+
+//!
+//! \brief The FileHeader struct Header of the cache file
+//!
+struct FileHeader
+{
+    char magic[8];              //!< file signature, see %kMagic
+    std::uint64_t data_size;    //!< size of all records following the header
+    std::uint64_t records;      //!< number of records
+    std::uint64_t generation;   //!< bumped every time records are evicted
+};
+
+//!
+//! \brief The RecordHeader struct Header of every cached puzzle record.
+//! Puzzle key and encoded moves sequences follow the header
+//!
+struct RecordHeader
+{
+    std::uint32_t record_size;  //!< size of the record, including header
+    std::uint32_t key_size;     //!< number of words in puzzle key
+    std::uint64_t hash;         //!< hash of puzzle key
+    std::uint32_t moves_size;   //!< size of encoded moves sequences
+    std::uint32_t reserved;     //!< keep record aligned
+};
+
+//!
+//! \brief RecordSize Gives record size aligned to 8 bytes
+//! \param key_size number of words in puzzle key
+//! \param moves_size size of encoded moves sequences
+//! \return record size in bytes
+//!
+size_t RecordSize (size_t key_size, size_t moves_size)
+{
+    size_t size = sizeof(RecordHeader) + key_size * sizeof(coordinate_t) +
+                  moves_size;
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+//!
+//! \brief The FileLock class Holds advisory lock of the file while in scope
+//!
+class FileLock
+{
+public:
+    //!
+    //! \brief FileLock Wait for the lock
+    //! \param fd locked file descriptor
+    //! \param operation LOCK_SH or LOCK_EX
+    //!
+    FileLock (int fd, int operation)
+        : fd_(fd)
+    {
+        int res;
+        do
+        {
+            res = flock(fd_, operation);
+        }
+        while ((res != 0) && (errno == EINTR));
+        locked_ = (res == 0);
+    }
+
+    ~FileLock ()
+    {
+        if (locked_)
+        {
+            flock(fd_, LOCK_UN);
+        }
+    }
+
+    FileLock (const FileLock &) = delete;
+    FileLock & operator= (const FileLock &) = delete;
+
+    //!
+    //! \brief IsLocked Check if the lock was taken
+    //! \return true if the lock is held
+    //!
+    bool IsLocked () const
+    {
+        return locked_;
+    }
+
+private:
+    int fd_;
+    bool locked_;
+};
+
+} // namespace
+
+SolutionCache::SolutionCache(const std::string &filename, size_t size_limit)
+    : fd_(-1)
+    , map_(nullptr)
+    , map_size_(0)
+    , size_limit_(size_limit)
+    , generation_(0)
+    , indexed_size_(0)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0)
+{
+    fd_ = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0)
+    {
+        return;
+    }
+
+    // Other process may be creating or updating the same file
+    FileLock lock (fd_, LOCK_EX);
+    struct stat st;
+    if (!lock.IsLocked() || (fstat(fd_, &st) != 0))
+    {
+        Unmap();
+        return;
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size);
+    bool valid = (file_size >= sizeof(FileHeader));
+    if (!Map(valid ? file_size : kMinimalMapSize))
+    {
+        return;
+    }
+
+    FileHeader * header = reinterpret_cast<FileHeader *>(map_);
+    if (valid)
+    {
+        valid = (std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0) &&
+                (header->data_size <= map_size_ - sizeof(FileHeader));
+    }
+
+    if (!valid)
+    {
+        // Cache can always be rebuilt, so start from scratch
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->data_size = 0;
+        header->records = 0;
+        header->generation = 0;
+    }
+
+    generation_ = header->generation;
+    BuildIndex(true);
+}
+
+SolutionCache::~SolutionCache()
+{
+    Unmap();
+}
+
+bool SolutionCache::IsOpen() const
+{
+    return (map_ != nullptr);
+}
+
+bool SolutionCache::Lookup(const input_data_t &key,
+                           std::list<moves_sequence_t> &solutions)
+{
+    if (!IsOpen())
+    {
+        ++misses_;
+        return false;
+    }
+
+    FileLock lock (fd_, LOCK_SH);
+    if (!lock.IsLocked() || !Sync(false))
+    {
+        ++misses_;
+        return false;
+    }
+
+    const FileHeader * header = reinterpret_cast<const FileHeader *>(map_);
+    size_t end = sizeof(FileHeader) + header->data_size;
+
+    auto range = index_.equal_range(Hash(key));
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        const char * record = map_ + i->second;
+        const RecordHeader * rh = reinterpret_cast<const RecordHeader *>(record);
+
+        if ((i->second + sizeof(RecordHeader) > end) ||
+            (rh->record_size != RecordSize(rh->key_size, rh->moves_size)) ||
+            (i->second + rh->record_size > end))
+        {
+            // record was damaged after index was built
+            continue;
+        }
+
+        if ((rh->key_size != key.size()) ||
+            (std::memcmp(record + sizeof(RecordHeader), key.data(),
+                         key.size() * sizeof(coordinate_t)) != 0))
+        {
+            // hash collision
+            continue;
+        }
+
+        const std::uint8_t * moves = reinterpret_cast<const std::uint8_t *>
+                (record + sizeof(RecordHeader) + key.size() * sizeof(coordinate_t));
+
+        solutions.clear();
+        moves_sequence_t sequence;
+        for (std::uint32_t j = 0; j < rh->moves_size; ++j)
+        {
+            if (moves[j] == kEndOfSequence)
+            {
+                solutions.push_back(sequence);
+                sequence.clear();
+            }
+            else
+            {
+                sequence.push_back(static_cast<Direction>(moves[j]));
+            }
+        }
+
+        ++hits_;
+        return true;
+    }
+
+    ++misses_;
+    return false;
+}
+
+bool SolutionCache::Store(const input_data_t &key,
+                          const std::list<moves_sequence_t> &solutions)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    size_t moves_size = 0;
+    for (auto & sequence : solutions)
+    {
+        moves_size += sequence.size() + 1;
+    }
+
+    size_t record_size = RecordSize(key.size(), moves_size);
+    if (record_size > size_limit_)
+    {
+        return false;
+    }
+
+    FileLock lock (fd_, LOCK_EX);
+    if (!lock.IsLocked() || !Sync(true))
+    {
+        return false;
+    }
+
+    FileHeader * header = reinterpret_cast<FileHeader *>(map_);
+    if (header->data_size + record_size > size_limit_)
+    {
+        Evict(record_size);
+    }
+
+    size_t offset = sizeof(FileHeader) + header->data_size;
+    if (offset + record_size > map_size_)
+    {
+        size_t new_size = map_size_ * 2;
+        while (offset + record_size > new_size)
+        {
+            new_size *= 2;
+        }
+        if (!Map(new_size))
+        {
+            return false;
+        }
+        header = reinterpret_cast<FileHeader *>(map_);
+    }
+
+    char * record = map_ + offset;
+    std::memset(record, 0, record_size);
+
+    RecordHeader * rh = reinterpret_cast<RecordHeader *>(record);
+    rh->record_size = static_cast<std::uint32_t>(record_size);
+    rh->key_size = static_cast<std::uint32_t>(key.size());
+    rh->hash = Hash(key);
+    rh->moves_size = static_cast<std::uint32_t>(moves_size);
+
+    std::memcpy(record + sizeof(RecordHeader), key.data(),
+                key.size() * sizeof(coordinate_t));
+
+    std::uint8_t * moves = reinterpret_cast<std::uint8_t *>
+            (record + sizeof(RecordHeader) + key.size() * sizeof(coordinate_t));
+    for (auto & sequence : solutions)
+    {
+        for (auto move : sequence)
+        {
+            *moves++ = static_cast<std::uint8_t>(move);
+        }
+        *moves++ = kEndOfSequence;
+    }
+
+    // Record is complete, now it can be made visible
+    header->data_size += record_size;
+    header->records += 1;
+    index_.insert(std::make_pair(rh->hash, offset));
+    indexed_size_ = header->data_size;
+
+    return true;
+}
+
+size_t SolutionCache::GetHits() const
+{
+    return hits_;
+}
+
+size_t SolutionCache::GetMisses() const
+{
+    return misses_;
+}
+
+size_t SolutionCache::GetEvictions() const
+{
+    return evictions_;
+}
+
+size_t SolutionCache::GetRecordsCount() const
+{
+    return index_.size();
+}
+
+size_t SolutionCache::GetDataSize() const
+{
+    if (!IsOpen())
+    {
+        return 0;
+    }
+    return reinterpret_cast<const FileHeader *>(map_)->data_size;
+}
+
+std::uint64_t SolutionCache::Hash(const input_data_t &key)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    const std::uint8_t * data = reinterpret_cast<const std::uint8_t *>(key.data());
+    for (size_t i = 0; i < key.size() * sizeof(coordinate_t); ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool SolutionCache::Map(size_t size)
+{
+    if (map_ != nullptr)
+    {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+
+    struct stat st;
+    if ((fstat(fd_, &st) != 0) ||
+        ((static_cast<size_t>(st.st_size) < size) &&
+         (ftruncate(fd_, static_cast<off_t>(size)) != 0)))
+    {
+        Unmap();
+        return false;
+    }
+
+    void * map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        Unmap();
+        return false;
+    }
+
+    map_ = static_cast<char *>(map);
+    map_size_ = size;
+    return true;
+}
+
+void SolutionCache::Unmap()
+{
+    if (map_ != nullptr)
+    {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+    if (fd_ >= 0)
+    {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool SolutionCache::Sync(bool repair)
+{
+    struct stat st;
+    if (fstat(fd_, &st) != 0)
+    {
+        return false;
+    }
+
+    // File could be grown by another process
+    size_t file_size = static_cast<size_t>(st.st_size);
+    if ((file_size > map_size_) && !Map(file_size))
+    {
+        return false;
+    }
+
+    const FileHeader * header = reinterpret_cast<const FileHeader *>(map_);
+    if ((header->generation != generation_) ||
+        (header->data_size < indexed_size_))
+    {
+        // Records were moved by eviction, old offsets are meaningless
+        index_.clear();
+        indexed_size_ = 0;
+        generation_ = header->generation;
+    }
+
+    if (header->data_size != indexed_size_)
+    {
+        // Damaged records are not indexed, so they are never returned
+        BuildIndex(repair);
+    }
+    return true;
+}
+
+bool SolutionCache::BuildIndex(bool repair)
+{
+    FileHeader * header = reinterpret_cast<FileHeader *>(map_);
+    size_t offset = sizeof(FileHeader) + indexed_size_;
+    size_t end = sizeof(FileHeader) + header->data_size;
+    if (end > map_size_)
+    {
+        end = map_size_;
+    }
+    std::uint64_t records = index_.size();
+
+    while (offset + sizeof(RecordHeader) <= end)
+    {
+        const RecordHeader * rh = reinterpret_cast<const RecordHeader *>(map_ + offset);
+        if ((rh->record_size < sizeof(RecordHeader)) ||
+            (rh->record_size != RecordSize(rh->key_size, rh->moves_size)) ||
+            (offset + rh->record_size > end))
+        {
+            break;
+        }
+        index_.insert(std::make_pair(rh->hash, offset));
+        offset += rh->record_size;
+        ++records;
+    }
+    indexed_size_ = offset - sizeof(FileHeader);
+
+    if ((indexed_size_ != header->data_size) || (records != header->records))
+    {
+        if (repair)
+        {
+            // Drop damaged tail of the file: it was never completely written
+            header->data_size = indexed_size_;
+            header->records = records;
+        }
+        return false;
+    }
+    return true;
+}
+
+void SolutionCache::Evict(size_t required)
+{
+    FileHeader * header = reinterpret_cast<FileHeader *>(map_);
+
+    // Free a quarter of the cache at once, so eviction is not triggered
+    // by every new record
+    size_t target = size_limit_ - size_limit_ / 4;
+    if (required > target)
+    {
+        target = required;
+    }
+
+    size_t data_start = sizeof(FileHeader);
+    size_t offset = data_start;
+    size_t end = data_start + header->data_size;
+    std::uint64_t dropped = 0;
+
+    while ((offset < end) && (end - offset + required > target))
+    {
+        const RecordHeader * rh = reinterpret_cast<const RecordHeader *>(map_ + offset);
+        offset += rh->record_size;
+        ++dropped;
+    }
+
+    std::memmove(map_ + data_start, map_ + offset, end - offset);
+    header->data_size = end - offset;
+    header->records -= dropped;
+    header->generation += 1;
+    evictions_ += dropped;
+
+    index_.clear();
+    indexed_size_ = 0;
+    generation_ = header->generation;
+    BuildIndex(true);
+}
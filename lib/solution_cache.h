@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLUTION_CACHE_H
+#define TG_SOLUTION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "tg_types.h"
+
+//!
+//! \brief The SolutionCache class Persistent storage of already solved games.
+//!
+//! Games are identified by puzzle key: input data in normalised form, see
+//! %GameTable::GetPuzzleKey(). Cache file is memory mapped and records are
+//! only appended to it. When file grows over the size limit oldest records
+//! are evicted.
+//!
+//! Several processes may share one cache file. Every access is done under
+//! advisory file lock, and changes made by other processes are picked up
+//! before the records are touched.
+//!
+class SolutionCache
+{
+public:
+    //! \brief kDefaultSizeLimit default limit of cached data size, bytes
+    static const size_t kDefaultSizeLimit = 64 * 1024 * 1024;
+
+    //!
+    //! \brief SolutionCache Open cache file, create it if it doesn't exist
+    //! \param filename cache file name
+    //! \param size_limit maximum size of cached records, bytes
+    //!
+    SolutionCache (const std::string & filename,
+                   size_t size_limit = kDefaultSizeLimit);
+    ~SolutionCache ();
+
+    SolutionCache (const SolutionCache &) = delete;
+    SolutionCache & operator= (const SolutionCache &) = delete;
+
+    //!
+    //! \brief IsOpen Check if cache file was opened and mapped successfully.
+    //! Closed cache misses every lookup and never stores anything
+    //! \return true if cache is usable
+    //!
+    bool IsOpen () const;
+
+    //!
+    //! \brief Lookup Find stored solutions for the puzzle
+    //! \param key puzzle key
+    //! \param solutions stored solutions, empty list for unsolvable puzzle
+    //! \return true if puzzle is found in the cache
+    //!
+    bool Lookup (const input_data_t & key,
+                 std::list <moves_sequence_t> & solutions);
+
+    //!
+    //! \brief Store Append puzzle solutions to the cache
+    //! \param key puzzle key
+    //! \param solutions all the best solutions of the puzzle
+    //! \return false if record cannot be stored
+    //!
+    bool Store (const input_data_t & key,
+                const std::list <moves_sequence_t> & solutions);
+
+    //!
+    //! \brief GetHits Number of successful lookups since cache was opened
+    //! \return hits count
+    //!
+    size_t GetHits () const;
+
+    //!
+    //! \brief GetMisses Number of failed lookups since cache was opened
+    //! \return misses count
+    //!
+    size_t GetMisses () const;
+
+    //!
+    //! \brief GetEvictions Number of records evicted since cache was opened
+    //! \return evicted records count
+    //!
+    size_t GetEvictions () const;
+
+    //!
+    //! \brief GetRecordsCount Number of records stored in the cache file
+    //! \return records count
+    //!
+    size_t GetRecordsCount () const;
+
+    //!
+    //! \brief GetDataSize Size of all stored records
+    //! \return size in bytes
+    //!
+    size_t GetDataSize () const;
+
+    //!
+    //! \brief Hash Hash function used to index puzzle keys
+    //! \param key puzzle key
+    //! \return 64-bit FNV-1a hash of the key
+    //!
+    static std::uint64_t Hash (const input_data_t & key);
+
+private:
+    //! \brief fd_ cache file descriptor
+    int fd_;
+
+    //! \brief map_ start of mapped file
+    char * map_;
+
+    //! \brief map_size_ size of mapped area and cache file
+    size_t map_size_;
+
+    //! \brief size_limit_ maximum size of stored records
+    size_t size_limit_;
+
+    //! \brief index_ record offsets by key hash
+    std::unordered_multimap <std::uint64_t, size_t> index_;
+
+    //! \brief generation_ eviction generation of the file %index_ built for
+    std::uint64_t generation_;
+
+    //! \brief indexed_size_ size of records data covered by %index_
+    size_t indexed_size_;
+
+    //! \brief hits_ lookup hits counter
+    size_t hits_;
+
+    //! \brief misses_ lookup misses counter
+    size_t misses_;
+
+    //! \brief evictions_ evicted records counter
+    size_t evictions_;
+
+    //!
+    //! \brief Map Map cache file of requested size to memory. File is
+    //! extended if needed
+    //! \param size new size of the file
+    //! \return false on error
+    //!
+    bool Map (size_t size);
+
+    //!
+    //! \brief Unmap release mapped memory and file descriptor
+    //!
+    void Unmap ();
+
+    //!
+    //! \brief Sync Catch up with changes made by other processes: remap
+    //! grown file and update %index_ if records were appended or evicted.
+    //! Must be called with the file lock held
+    //! \param repair drop damaged tail of the file, requires exclusive lock
+    //! \return false on error
+    //!
+    bool Sync (bool repair);
+
+    //!
+    //! \brief BuildIndex scan records not yet covered by %index_ and add
+    //! them to it
+    //! \param repair drop damaged tail of the file, requires exclusive lock
+    //! \return false if file is corrupted
+    //!
+    bool BuildIndex (bool repair);
+
+    //!
+    //! \brief Evict remove oldest records until %required bytes can be
+    //! appended without exceeding size limit
+    //! \param required size of the record to be appended
+    //!
+    void Evict (size_t required);
+};
+
+#endif // TG_SOLUTION_CACHE_H
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solution_graph.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "tg_utils.h"
+
+namespace
+{
+
+//! \brief kNoNumber state is not numbered yet
+const std::uint32_t kNoNumber = std::numeric_limits<std::uint32_t>::max();
+
+} // namespace
+
+SolutionGraph::Iterator::Iterator(const SolutionGraph &graph)
+    : graph_(graph)
+    , path_(graph.GetDepth())
+    , started_(false)
+    , done_(graph.IsEmpty())
+{
+}
+
+bool SolutionGraph::Iterator::Next(moves_sequence_t &moves)
+{
+    if (done_)
+    {
+        return false;
+    }
+
+    if (!started_)
+    {
+        started_ = true;
+        Descend(0, 0);
+    }
+    else
+    {
+        // take next edge of the deepest state which has one
+        size_t layer = path_.size();
+        while (layer-- > 0)
+        {
+            const Edge & edge = graph_.layers_[layer][path_[layer]];
+            if (path_[layer] + 1 < graph_.offsets_[layer][edge.from + 1])
+            {
+                ++path_[layer];
+                Descend(layer + 1, graph_.layers_[layer][path_[layer]].next);
+                break;
+            }
+        }
+        if (layer == static_cast<size_t>(-1))
+        {
+            done_ = true;
+            return false;
+        }
+    }
+
+    moves.resize(path_.size());
+    for (size_t layer = 0; layer < path_.size(); ++layer)
+    {
+        moves[layer] = graph_.layers_[layer][path_[layer]].to;
+    }
+    return true;
+}
+
+void SolutionGraph::Iterator::Descend(size_t layer, std::uint32_t state)
+{
+    for (; layer < path_.size(); ++layer)
+    {
+        path_[layer] = graph_.offsets_[layer][state];
+        state = graph_.layers_[layer][path_[layer]].next;
+    }
+}
+
+SolutionGraph::SolutionGraph()
+    : won_(false)
+{
+}
+
+void SolutionGraph::Clear()
+{
+    won_ = false;
+    layers_.clear();
+    offsets_.clear();
+}
+
+void SolutionGraph::Assign(std::vector<std::vector<Edge> > &&layers)
+{
+    won_ = true;
+    layers_ = std::move(layers);
+    offsets_.assign(layers_.size(), std::vector<size_t>());
+
+    // States are renumbered in order they are met by moves sorted by
+    // state and direction, so the graph doesn't depend on the search
+    // which has found it
+    std::vector <std::uint32_t> numbers (1, 0);
+    std::uint32_t states = 1;
+    for (size_t k = 0; k < layers_.size(); ++k)
+    {
+        std::vector <Edge> & edges = layers_[k];
+        std::uint32_t next_states = 0;
+        for (auto & edge : edges)
+        {
+            edge.from = numbers[edge.from];
+            next_states = std::max(next_states, edge.next + 1);
+        }
+        std::sort(edges.begin(), edges.end(), [] (const Edge & a, const Edge & b)
+        {
+            return (a.from < b.from) || ((a.from == b.from) && (a.to < b.to));
+        });
+        edges.erase(std::unique(edges.begin(), edges.end(),
+                                [] (const Edge & a, const Edge & b)
+        {
+            return (a.from == b.from) && (a.to == b.to);
+        }), edges.end());
+
+        std::vector <size_t> & offsets = offsets_[k];
+        offsets.assign(states + 1, 0);
+        std::vector <std::uint32_t> next_numbers (next_states, kNoNumber);
+        std::uint32_t count = 0;
+        for (auto & edge : edges)
+        {
+            ++offsets[edge.from + 1];
+            if (next_numbers[edge.next] == kNoNumber)
+            {
+                next_numbers[edge.next] = count++;
+            }
+            edge.next = next_numbers[edge.next];
+        }
+        for (std::uint32_t i = 0; i < states; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        states = count;
+        numbers.swap(next_numbers);
+    }
+}
+
+bool SolutionGraph::IsEmpty() const
+{
+    return !won_;
+}
+
+size_t SolutionGraph::GetDepth() const
+{
+    return layers_.size();
+}
+
+size_t SolutionGraph::GetStatesCount() const
+{
+    if (!won_)
+    {
+        return 0;
+    }
+    // every layer but the last one is numbered by offsets
+    size_t count = 1;
+    for (auto & offsets : offsets_)
+    {
+        count += offsets.size() - 1;
+    }
+    return count;
+}
+
+size_t SolutionGraph::GetMovesCount() const
+{
+    size_t count = 0;
+    for (auto & edges : layers_)
+    {
+        count += edges.size();
+    }
+    return count;
+}
+
+std::uint64_t SolutionGraph::GetSequencesCount() const
+{
+    if (!won_)
+    {
+        return 0;
+    }
+
+    // number of sequences from every state to the win, from the last layer
+    const std::uint64_t kMax = std::numeric_limits<std::uint64_t>::max();
+    std::vector <std::uint64_t> counts (1, 1);
+    for (size_t k = layers_.size(); k-- > 0; )
+    {
+        std::vector <std::uint64_t> previous (offsets_[k].size() - 1, 0);
+        for (auto & edge : layers_[k])
+        {
+            std::uint64_t & count = previous[edge.from];
+            count = (kMax - count < counts[edge.next]) ? kMax
+                                                       : count + counts[edge.next];
+        }
+        counts.swap(previous);
+    }
+    return counts[0];
+}
+
+const std::vector<SolutionGraph::Edge> &SolutionGraph::GetEdges(size_t layer) const
+{
+    return layers_[layer];
+}
+
+std::list<moves_sequence_t> SolutionGraph::Expand() const
+{
+    std::list <moves_sequence_t> moves;
+    Iterator iterator (*this);
+    moves_sequence_t sequence;
+    while (iterator.Next(sequence))
+    {
+        moves.push_back(sequence);
+    }
+    return moves;
+}
+
+void SolutionGraph::Print(std::ostream &os) const
+{
+    if (!won_)
+    {
+        return;
+    }
+
+    os << GetDepth() << " " << GetStatesCount() << " "
+       << GetSequencesCount() << "\n";
+
+    size_t first = 0;
+    for (size_t k = 0; k < layers_.size(); ++k)
+    {
+        size_t next_first = first + offsets_[k].size() - 1;
+        const std::vector <Edge> & edges = layers_[k];
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if ((i == 0) || (edges[i].from != edges[i - 1].from))
+            {
+                if (i != 0)
+                {
+                    os << "\n";
+                }
+                os << first + edges[i].from;
+            }
+            os << " " << edges[i].to << " " << next_first + edges[i].next;
+        }
+        if (!edges.empty())
+        {
+            os << "\n";
+        }
+        first = next_first;
+    }
+}
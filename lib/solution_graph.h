@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLUTION_GRAPH_H
+#define TG_SOLUTION_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <ostream>
+#include <vector>
+
+#include "tg_types.h"
+
+//!
+//! \brief The SolutionGraph class All the best moves sequences of the game
+//! as graph of states.
+//!
+//! States are grouped by layers: layer k keeps states reached by k moves,
+//! which lead to the win by the best sequence. Layer 0 is the start state,
+//! the last layer is the won state. Edges are moves from every state to
+//! states of the next layer, every path from the start to the win is one of
+//! the best sequences. Number of sequences may grow exponentially with
+//! their length, but size of the graph grows only with number of states.
+//!
+class SolutionGraph
+{
+public:
+    //!
+    //! \brief The Edge struct Move from state of one layer to the state of
+    //! the next layer. States are numbered from 0 inside every layer
+    //!
+    struct Edge
+    {
+        std::uint32_t from;     //!< state before the move
+        Direction to;           //!< move direction
+        std::uint32_t next;     //!< state after the move
+    };
+
+    //!
+    //! \brief The Iterator class Expands the graph to moves sequences one by
+    //! one, in lexicographic order. Only current sequence is kept. Graph
+    //! must not be changed while it is iterated
+    //!
+    class Iterator
+    {
+    public:
+        //!
+        //! \brief Iterator Prepare to expand the graph
+        //! \param graph solutions graph
+        //!
+        explicit Iterator (const SolutionGraph & graph);
+
+        //!
+        //! \brief Next gives next moves sequence
+        //! \param moves moves sequence
+        //! \return false if all sequences are given
+        //!
+        bool Next (moves_sequence_t & moves);
+
+    private:
+        //! \brief graph_ graph being expanded
+        const SolutionGraph & graph_;
+
+        //! \brief path_ index of edge taken at every layer
+        std::vector <size_t> path_;
+
+        //! \brief started_ true if first sequence is given
+        bool started_;
+
+        //! \brief done_ true if all sequences are given
+        bool done_;
+
+        //!
+        //! \brief Descend take first edges from the state down to the won
+        //! state
+        //! \param layer layer of the state
+        //! \param state state number in the layer
+        //!
+        void Descend (size_t layer, std::uint32_t state);
+    };
+
+    //!
+    //! \brief SolutionGraph Create empty graph: game cannot be won
+    //!
+    SolutionGraph ();
+
+    //!
+    //! \brief Clear make graph empty
+    //!
+    void Clear ();
+
+    //!
+    //! \brief Assign set graph of won game
+    //! \param layers edges from every layer to the next one. States of
+    //! every layer are numbered densely, every state except the won one
+    //! has outgoing edges. Duplicate edges are dropped
+    //!
+    void Assign (std::vector <std::vector <Edge> > && layers);
+
+    //!
+    //! \brief IsEmpty check if graph has no sequences
+    //! \return true if game cannot be won
+    //!
+    bool IsEmpty () const;
+
+    //!
+    //! \brief GetDepth gives length of the best sequences
+    //! \return number of moves
+    //!
+    size_t GetDepth () const;
+
+    //!
+    //! \brief GetStatesCount gives number of states in all the layers
+    //! \return states count, 0 if graph is empty
+    //!
+    size_t GetStatesCount () const;
+
+    //!
+    //! \brief GetMovesCount gives number of edges
+    //! \return edges count
+    //!
+    size_t GetMovesCount () const;
+
+    //!
+    //! \brief GetSequencesCount gives number of the best sequences without
+    //! expanding them
+    //! \return sequences count, UINT64_MAX if it doesn't fit to 64 bits
+    //!
+    std::uint64_t GetSequencesCount () const;
+
+    //!
+    //! \brief GetEdges gives edges from the layer
+    //! \param layer layer number, less than %GetDepth()
+    //! \return edges sorted by state and direction
+    //!
+    const std::vector <Edge> & GetEdges (size_t layer) const;
+
+    //!
+    //! \brief Expand gives all the sequences at once
+    //! \return moves sequences in lexicographic order
+    //!
+    std::list <moves_sequence_t> Expand () const;
+
+    //!
+    //! \brief Print print the graph in text form. First line is the depth,
+    //! number of states and number of sequences. Then every state with
+    //! outgoing moves is printed on its own line: state number followed by
+    //! pairs of move direction and next state number. States are numbered
+    //! layer by layer, the start state is 0 and the won state is the last
+    //! one. Nothing is printed for empty graph
+    //! \param os output stream
+    //!
+    void Print (std::ostream & os) const;
+
+private:
+    //! \brief won_ true if game can be won
+    bool won_;
+
+    //! \brief layers_ edges from every layer to the next one
+    std::vector <std::vector <Edge> > layers_;
+
+    //! \brief offsets_ first edge of every state in every layer, the last
+    //! element is the number of layer edges
+    std::vector <std::vector <size_t> > offsets_;
+};
+
+#endif // TG_SOLUTION_GRAPH_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solve_task.h"
+
+#include <chrono>
+#include <exception>
+
+SolveTask::SolveTask(GameTable &table, callback_t done)
+    : table_(table)
+    , cancel_(false)
+    , done_(done)
+    , future_(promise_.get_future().share())
+{
+    table_.SetCancelFlag(&cancel_);
+    table_.SetProgress(&progress_);
+    thread_ = std::thread(&SolveTask::Run, this);
+}
+
+SolveTask::~SolveTask()
+{
+    Cancel();
+    thread_.join();
+}
+
+void SolveTask::Cancel()
+{
+    cancel_ = true;
+}
+
+bool SolveTask::IsDone() const
+{
+    return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void SolveTask::Wait() const
+{
+    future_.wait();
+}
+
+SolveTask::future_t SolveTask::GetFuture() const
+{
+    return future_;
+}
+
+size_t SolveTask::GetDepth() const
+{
+    return progress_.depth.load(std::memory_order_relaxed);
+}
+
+size_t SolveTask::GetExpanded() const
+{
+    return progress_.expanded.load(std::memory_order_relaxed);
+}
+
+void SolveTask::Run()
+{
+    // exception must not leave the thread, it is passed to the future
+    std::exception_ptr error;
+    try
+    {
+        table_.CalculateMoves();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    // flag and progress die with the task, table may outlive it
+    table_.SetCancelFlag(nullptr);
+    table_.SetProgress(nullptr);
+
+    if (!error)
+    {
+        try
+        {
+            if (done_)
+            {
+                done_(table_);
+            }
+            promise_.set_value(table_.GetMoves());
+            return;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+    promise_.set_exception(error);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLVE_TASK_H
+#define TG_SOLVE_TASK_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <list>
+#include <thread>
+
+#include "search_stats.h"
+#include "table.h"
+#include "tg_types.h"
+
+//!
+//! \brief The SolveTask class Game solved by %GameTable::CalculateMoves() in
+//! background thread.
+//!
+//! Task owns the thread, the table is only borrowed: it must outlive the
+//! task and must not be used by anybody else until the task is done. The
+//! search can be cancelled at any time, it stops within milliseconds and
+//! releases its memory then. Task destroyed before it is done cancels the
+//! search and waits for the thread.
+//!
+class SolveTask
+{
+public:
+    //! \brief callback_t function called when search is done or cancelled
+    using callback_t = std::function <void (const GameTable &)>;
+
+    //! \brief future_t best moves sequences of the game, empty if game
+    //! cannot be won or search is cancelled
+    using future_t = std::shared_future <std::list <moves_sequence_t> >;
+
+    //!
+    //! \brief SolveTask Start search in new thread
+    //! \param table game to solve
+    //! \param done function called in search thread when search is over,
+    //! before the future becomes ready. Can be empty. Exception thrown by
+    //! the search or the callback is rethrown by the future
+    //!
+    SolveTask (GameTable & table, callback_t done = callback_t());
+    ~SolveTask ();
+
+    SolveTask (const SolveTask &) = delete;
+    SolveTask & operator= (const SolveTask &) = delete;
+
+    //!
+    //! \brief Cancel ask search to stop. Future becomes ready when it
+    //! stops, %SearchStats::cancelled is set then
+    //!
+    void Cancel ();
+
+    //!
+    //! \brief IsDone check if search is over
+    //! \return true if future is ready
+    //!
+    bool IsDone () const;
+
+    //!
+    //! \brief Wait wait until search is over
+    //!
+    void Wait () const;
+
+    //!
+    //! \brief GetFuture gives moves which will be found by the search
+    //! \return future moves
+    //!
+    future_t GetFuture () const;
+
+    //!
+    //! \brief GetDepth gives depth being searched now
+    //! \return depth
+    //!
+    size_t GetDepth () const;
+
+    //!
+    //! \brief GetExpanded gives number of states expanded so far
+    //! \return states count
+    //!
+    size_t GetExpanded () const;
+
+private:
+    //! \brief table_ game being solved
+    GameTable & table_;
+
+    //! \brief cancel_ cancellation flag of the search
+    std::atomic <bool> cancel_;
+
+    //! \brief progress_ progress published by the search
+    SearchProgress progress_;
+
+    //! \brief done_ function called when search is over
+    callback_t done_;
+
+    //! \brief promise_ search result
+    std::promise <std::list <moves_sequence_t> > promise_;
+
+    //! \brief future_ search result
+    future_t future_;
+
+    //! \brief thread_ search thread
+    std::thread thread_;
+
+    //!
+    //! \brief Run search the game, called in search thread
+    //!
+    void Run ();
+};
+
+#endif // TG_SOLVE_TASK_H
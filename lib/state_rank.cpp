@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "state_rank.h"
+
+#include <cstdlib>
+
+StateRanker::StateRanker(std::uint32_t cells_count, size_t balls_count)
+    : radix_(static_cast<std::uint64_t>(cells_count) + 1)
+    , balls_count_(balls_count)
+    , space_size_(1)
+{
+    for (size_t i = 0; i < balls_count_; ++i)
+    {
+        if (space_size_ > UINT64_MAX / radix_)
+        {
+            space_size_ = 0;
+            break;
+        }
+        space_size_ *= radix_;
+    }
+}
+
+std::uint64_t StateRanker::GetSpaceSize() const
+{
+    return space_size_;
+}
+
+std::uint32_t StateRanker::GetRemovedCell() const
+{
+    return static_cast<std::uint32_t>(radix_ - 1);
+}
+
+std::uint64_t StateRanker::Rank(const std::vector<std::uint32_t> &cells) const
+{
+    std::uint64_t rank = 0;
+    for (size_t i = balls_count_; i-- > 0; )
+    {
+        rank = rank * radix_ + cells[i];
+    }
+    return rank;
+}
+
+void StateRanker::Unrank(std::uint64_t rank, std::vector<std::uint32_t> &cells) const
+{
+    cells.resize(balls_count_);
+    for (size_t i = 0; i < balls_count_; ++i)
+    {
+        cells[i] = static_cast<std::uint32_t>(rank % radix_);
+        rank /= radix_;
+    }
+}
+
+void VisitedStates::Deleter::operator() (std::uint64_t * words) const
+{
+    std::free(words);
+}
+
+VisitedStates::VisitedStates()
+    : words_count_(0)
+    , planes_count_(0)
+{
+}
+
+bool VisitedStates::Reset(std::uint64_t space_size, size_t planes,
+                          size_t memory_limit)
+{
+    planes_.reset();
+    next_.clear();
+    words_count_ = 0;
+    planes_count_ = 0;
+
+    std::uint64_t words = (space_size + 63) / 64;
+    if ((space_size == 0) || (planes == 0) ||
+        (words > memory_limit / sizeof(std::uint64_t) / planes))
+    {
+        return false;
+    }
+
+    // calloc takes big blocks from zero pages, so only touched part of
+    // sparse planes is ever backed by memory
+    std::uint64_t * memory = static_cast<std::uint64_t *>(
+                std::calloc(words * planes, sizeof(std::uint64_t)));
+    if (memory == nullptr)
+    {
+        return false;
+    }
+    planes_.reset(memory);
+    words_count_ = static_cast<size_t>(words);
+    planes_count_ = planes;
+    return true;
+}
+
+bool VisitedStates::IsEnabled() const
+{
+    return planes_count_ != 0;
+}
+
+bool VisitedStates::IsVisited(std::uint64_t rank) const
+{
+    return (planes_[rank / 64] >> (rank % 64)) & 1;
+}
+
+bool VisitedStates::Visit(std::uint64_t rank)
+{
+    std::uint64_t & word = planes_[rank / 64];
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << (rank % 64);
+    if (word & bit)
+    {
+        return false;
+    }
+    word |= bit;
+    return true;
+}
+
+void VisitedStates::VisitNext(std::uint64_t rank)
+{
+    std::uint64_t & word = planes_[words_count_ + rank / 64];
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << (rank % 64);
+    if (!(word & bit))
+    {
+        word |= bit;
+        next_.push_back(rank);
+    }
+}
+
+void VisitedStates::NextDepth()
+{
+    for (auto rank : next_)
+    {
+        std::uint64_t bit = static_cast<std::uint64_t>(1) << (rank % 64);
+        planes_[rank / 64] |= bit;
+        planes_[words_count_ + rank / 64] &= ~bit;
+    }
+    next_.clear();
+}
+
+size_t VisitedStates::GetBytes() const
+{
+    return words_count_ * planes_count_ * sizeof(std::uint64_t);
+}
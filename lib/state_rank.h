@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_STATE_RANK_H
+#define TG_STATE_RANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//!
+//! \brief The StateRanker class Perfect ranking of game states.
+//!
+//! State is the cell of every ball or special "removed" value for balls in
+//! their holes, so set of open holes is a part of the state too. Cell of
+//! ball i is digit i of the rank in base (cells count + 1), so every state
+//! has unique rank in range [0, GetSpaceSize()) and every rank describes
+//! some state.
+//!
+class StateRanker
+{
+public:
+    //!
+    //! \brief StateRanker Prepare ranking
+    //! \param cells_count number of cells, balls can stay in
+    //! \param balls_count number of balls
+    //!
+    StateRanker (std::uint32_t cells_count, size_t balls_count);
+
+    //!
+    //! \brief GetSpaceSize number of different ranks
+    //! \return ranks count, 0 if it doesn't fit to 64 bits
+    //!
+    std::uint64_t GetSpaceSize () const;
+
+    //!
+    //! \brief GetRemovedCell cell value for balls in their holes
+    //! \return cell value
+    //!
+    std::uint32_t GetRemovedCell () const;
+
+    //!
+    //! \brief Rank gives rank of the state
+    //! \param cells cell of every ball, %GetRemovedCell() for removed ones
+    //! \return rank
+    //!
+    std::uint64_t Rank (const std::vector <std::uint32_t> & cells) const;
+
+    //!
+    //! \brief Unrank gives state by its rank
+    //! \param rank rank
+    //! \param cells cell of every ball, %GetRemovedCell() for removed ones
+    //!
+    void Unrank (std::uint64_t rank, std::vector <std::uint32_t> & cells) const;
+
+private:
+    //! \brief radix_ base of rank digits
+    std::uint64_t radix_;
+
+    //! \brief balls_count_ number of balls
+    size_t balls_count_;
+
+    //! \brief space_size_ number of ranks, 0 on overflow
+    std::uint64_t space_size_;
+};
+
+//!
+//! \brief The VisitedStates class Visited states as bit planes indexed by
+//! state rank, no hashing at all.
+//!
+//! Plane 0 keeps states reached at previous depths, plane 1 keeps states of
+//! the depth being generated. Generic search keeps every node reached at
+//! the same depth, so it needs both planes; search which deduplicates
+//! layers itself needs only plane 0.
+//!
+class VisitedStates
+{
+public:
+    //! \brief kDefaultMemoryLimit default limit of memory for bit planes
+    static const size_t kDefaultMemoryLimit = 32 * 1024 * 1024;
+
+    VisitedStates ();
+
+    //!
+    //! \brief Reset allocate empty planes for the states space
+    //! \param space_size number of state ranks, 0 if unknown
+    //! \param planes number of planes, 1 or 2
+    //! \param memory_limit maximum size of all planes, bytes
+    //! \return false if planes don't fit to the limit, visited states are
+    //! not tracked then
+    //!
+    bool Reset (std::uint64_t space_size, size_t planes, size_t memory_limit);
+
+    //!
+    //! \brief IsEnabled check if visited states are tracked
+    //! \return true if planes are allocated
+    //!
+    bool IsEnabled () const;
+
+    //!
+    //! \brief IsVisited check if state was reached at previous depths
+    //! \param rank state rank
+    //! \return true if state is in plane 0
+    //!
+    bool IsVisited (std::uint64_t rank) const;
+
+    //!
+    //! \brief Visit mark state as reached at previous depths
+    //! \param rank state rank
+    //! \return false if state was already marked
+    //!
+    bool Visit (std::uint64_t rank);
+
+    //!
+    //! \brief VisitNext mark state as reached at depth being generated
+    //! \param rank state rank
+    //!
+    void VisitNext (std::uint64_t rank);
+
+    //!
+    //! \brief NextDepth move states of depth being generated to plane 0
+    //!
+    void NextDepth ();
+
+    //!
+    //! \brief GetBytes size of allocated planes
+    //! \return size in bytes
+    //!
+    size_t GetBytes () const;
+
+private:
+    //! \brief Deleter release planes memory
+    struct Deleter
+    {
+        void operator() (std::uint64_t * words) const;
+    };
+
+    //! \brief words_count_ size of one plane in 64-bit words
+    size_t words_count_;
+
+    //! \brief planes_count_ number of allocated planes
+    size_t planes_count_;
+
+    //! \brief planes_ bit planes, zero pages are mapped lazily
+    std::unique_ptr <std::uint64_t [], Deleter> planes_;
+
+    //! \brief next_ ranks marked in plane 1
+    std::vector <std::uint64_t> next_;
+};
+
+#endif // TG_STATE_RANK_H
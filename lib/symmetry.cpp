@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "symmetry.h"
+
+#include <algorithm>
+
+#include "tg_utils.h"
+
+Symmetry Inverse(Symmetry s)
+{
+    switch (s)
+    {
+    case Symmetry::Rotate90:
+        return Symmetry::Rotate270;
+    case Symmetry::Rotate270:
+        return Symmetry::Rotate90;
+    case Symmetry::Identity:
+    case Symmetry::Rotate180:
+    case Symmetry::FlipHorizontal:
+    case Symmetry::FlipVertical:
+    case Symmetry::Transpose:
+    case Symmetry::AntiTranspose:
+        break;
+    }
+    // all the others are involutions
+    return s;
+}
+
+coordinates_t Transform(const coordinates_t &c, Symmetry s,
+                        coordinate_t table_size)
+{
+    const coordinate_t n = table_size + 1;
+
+    switch (s)
+    {
+    case Symmetry::Identity:
+        break;
+    case Symmetry::Rotate90:
+        return coordinates_t(n - c.y, c.x);
+    case Symmetry::Rotate180:
+        return coordinates_t(n - c.x, n - c.y);
+    case Symmetry::Rotate270:
+        return coordinates_t(c.y, n - c.x);
+    case Symmetry::FlipHorizontal:
+        return coordinates_t(n - c.x, c.y);
+    case Symmetry::FlipVertical:
+        return coordinates_t(c.x, n - c.y);
+    case Symmetry::Transpose:
+        return coordinates_t(c.y, c.x);
+    case Symmetry::AntiTranspose:
+        return coordinates_t(n - c.y, n - c.x);
+    }
+    return c;
+}
+
+Direction Transform(Direction d, Symmetry s)
+{
+    // Transform neighbour of some cell and see where it is now
+    const coordinate_t table_size = 3;
+    const coordinates_t center (2, 2);
+
+    coordinates_t neighbour = Transform(GetNeighbourCell(center, d), s, table_size);
+
+    for (auto to : {Direction::North, Direction::West,
+                    Direction::South, Direction::East})
+    {
+        if (GetNeighbourCell(center, to) == neighbour)
+        {
+            return to;
+        }
+    }
+    return d;
+}
+
+moves_sequence_t Transform(const moves_sequence_t &moves, Symmetry s)
+{
+    moves_sequence_t transformed;
+    transformed.reserve(moves.size());
+    for (auto move : moves)
+    {
+        transformed.push_back(Transform(move, s));
+    }
+    return transformed;
+}
+
+input_data_t NormalisePuzzleKey(const input_data_t &in)
+{
+    const size_t header_size = 3;
+    const size_t balls_count = in.at(1);
+    const size_t walls_count = in.at(2);
+    const size_t start_of_walls = header_size + balls_count * 4;
+
+    std::vector <wall_coordinates_t> walls;
+    walls.reserve(walls_count);
+    for (size_t i = 0; i < walls_count; ++i)
+    {
+        coordinates_t first  (in.at(start_of_walls + i*4),
+                              in.at(start_of_walls + i*4 + 1));
+        coordinates_t second (in.at(start_of_walls + i*4 + 2),
+                              in.at(start_of_walls + i*4 + 3));
+        if ((second.x < first.x) || (second.y < first.y))
+        {
+            std::swap(first, second);
+        }
+        walls.push_back(wall_coordinates_t(first, second));
+    }
+
+    // Row by row, eastern wall of the cell goes before southern one
+    std::sort(walls.begin(), walls.end(),
+              [](const wall_coordinates_t & l, const wall_coordinates_t & r)
+    {
+        if (l.first.y != r.first.y)
+        {
+            return l.first.y < r.first.y;
+        }
+        if (l.first.x != r.first.x)
+        {
+            return l.first.x < r.first.x;
+        }
+        return (l.second.x > r.second.x) && (r.second.x == r.first.x);
+    });
+    walls.erase(std::unique(walls.begin(), walls.end()), walls.end());
+
+    input_data_t key (in.begin(), in.begin() + start_of_walls);
+    key[2] = static_cast<coordinate_t>(walls.size());
+    for (auto & wall : walls)
+    {
+        key.insert(key.end(), {wall.first.x, wall.first.y,
+                               wall.second.x, wall.second.y});
+    }
+    return key;
+}
+
+input_data_t Transform(const input_data_t &key, Symmetry s)
+{
+    const coordinate_t table_size = key.at(0);
+    const size_t header_size = 3;
+
+    // Every object is described by pairs of coordinates: balls, holes,
+    // and pairs of cells for walls. Transform all of them
+    input_data_t transformed (key);
+    for (size_t i = header_size; i + 1 < key.size(); i += 2)
+    {
+        coordinates_t c = Transform(coordinates_t(key[i], key[i + 1]),
+                                    s, table_size);
+        transformed[i]     = c.x;
+        transformed[i + 1] = c.y;
+    }
+    return NormalisePuzzleKey(transformed);
+}
+
+CanonicalPuzzle Canonicalise(const input_data_t &key)
+{
+    CanonicalPuzzle canonical = {NormalisePuzzleKey(key), Symmetry::Identity};
+
+    for (unsigned i = 1; i < kSymmetriesCount; ++i)
+    {
+        Symmetry s = static_cast<Symmetry>(i);
+        input_data_t transformed = Transform(key, s);
+        if (transformed < canonical.key)
+        {
+            canonical.key = transformed;
+            canonical.symmetry = s;
+        }
+    }
+    return canonical;
+}
+
+void SortMoves(std::list<moves_sequence_t> &moves)
+{
+    // Search tries moves in order of Direction values, so shortest
+    // sequences are found in lexicographical order
+    moves.sort();
+}
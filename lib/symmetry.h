@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SYMMETRY_H
+#define TG_SYMMETRY_H
+
+#include <list>
+
+#include "tg_types.h"
+
+//! \file
+
+//!
+//! \brief The Symmetry enum Transformations of square game board which keep
+//! it square: rotations and reflections
+//!
+enum class Symmetry
+{
+    Identity,       //!< board is not changed
+    Rotate90,       //!< rotate clockwise by 90 degrees
+    Rotate180,      //!< rotate by 180 degrees
+    Rotate270,      //!< rotate clockwise by 270 degrees
+    FlipHorizontal, //!< mirror west and east sides
+    FlipVertical,   //!< mirror north and south sides
+    Transpose,      //!< reflect over diagonal from north-west corner
+    AntiTranspose   //!< reflect over diagonal from north-east corner
+};
+
+//! \brief kSymmetriesCount number of board transformations
+const unsigned kSymmetriesCount = 8;
+
+//!
+//! \brief Inverse Gives transformation which cancels the given one
+//! \param s transformation
+//! \return inverse transformation
+//!
+Symmetry Inverse (Symmetry s);
+
+//!
+//! \brief Transform Gives cell position on transformed board
+//! \param c cell coordinates
+//! \param s transformation
+//! \param table_size size of game board
+//! \return cell coordinates on transformed board
+//!
+coordinates_t Transform (const coordinates_t & c, Symmetry s,
+                         coordinate_t table_size);
+
+//!
+//! \brief Transform Gives move direction on transformed board
+//! \param d move direction
+//! \param s transformation
+//! \return move direction on transformed board
+//!
+Direction Transform (Direction d, Symmetry s);
+
+//!
+//! \brief Transform Gives moves sequence on transformed board
+//! \param moves moves sequence
+//! \param s transformation
+//! \return moves sequence on transformed board
+//!
+moves_sequence_t Transform (const moves_sequence_t & moves, Symmetry s);
+
+//!
+//! \brief NormalisePuzzleKey Convert input data to puzzle key. Walls are
+//! described by western or northern cell first and are sorted row by row
+//! \see %GameTable::GetPuzzleKey()
+//! \param in valid input data
+//! \return puzzle key
+//!
+input_data_t NormalisePuzzleKey (const input_data_t & in);
+
+//!
+//! \brief Transform Gives puzzle key of transformed board
+//! \param key puzzle key
+//! \param s transformation
+//! \return puzzle key of transformed board
+//!
+input_data_t Transform (const input_data_t & key, Symmetry s);
+
+//!
+//! \brief The CanonicalPuzzle struct Puzzle in canonical form: the least one
+//! of all its transformations
+//!
+struct CanonicalPuzzle
+{
+    //! \brief key puzzle key of canonical form
+    input_data_t key;
+
+    //! \brief symmetry transformation from original puzzle to canonical form
+    Symmetry symmetry;
+};
+
+//!
+//! \brief Canonicalise Find canonical form of the puzzle. All rotated and
+//! mirrored copies of the puzzle have the same canonical form
+//! \param key puzzle key
+//! \return canonical form and transformation to get it
+//!
+CanonicalPuzzle Canonicalise (const input_data_t & key);
+
+//!
+//! \brief SortMoves Sort moves sequences in the same order as search finds
+//! them. Needed after transforming solutions between boards
+//! \param moves moves sequences
+//!
+void SortMoves (std::list <moves_sequence_t> & moves);
+
+#endif // TG_SYMMETRY_H
@@ -33,80 +33,142 @@
 
 #include <iomanip>
 #include <cassert>
+#include <deque>
+#include <algorithm>
+#include <new>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "tg_utils.h"
+#include "symmetry.h"
+#include "direction_traits.h"
+#include "packed_solver.h"
+#include "analysis.h"
+#include "generator.h"
 
-
-GameTable::GameTable(const InputData &in)
+namespace
 {
-    table_size_ = in.GetTableSize();
 
-    for (coordinate_t i=1; i<=table_size_; ++i)
+//!
+//! \brief HashBalls Hash function of balls positions, used to find states
+//! already reached by approximate search
+//! \param balls balls positions
+//! \return 64-bit FNV-1a hash
+//!
+std::uint64_t HashBalls (const positions_t & balls)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto & ball : balls)
     {
-        for (coordinate_t j=1; j<table_size_; ++j)
+        for (coordinate_t value : {ball.first.x, ball.first.y, ball.second})
         {
-            board_.insert(std::make_pair(coordinates_t(i,j), BoardCell()));
+            hash ^= value;
+            hash *= 1099511628211ULL;
         }
     }
+    return hash;
+}
 
-    // add walls on borders
-    for (coordinate_t i=1; i<=table_size_; ++i)
+//!
+//! \brief PositionsKey Key of balls positions, used to merge equal states
+//! of solutions graph
+//! \param balls balls positions
+//! \return key
+//!
+std::string PositionsKey (const positions_t & balls)
+{
+    std::vector <coordinate_t> values;
+    values.reserve(balls.size() * 3);
+    for (auto & ball : balls)
     {
-        coordinates_t c_up    (i, 1);
-        coordinates_t c_down  (i, table_size_);
-        coordinates_t c_left  (1, i);
-        coordinates_t c_right (table_size_, i);
-
-        board_[c_up].AddWall(Direction::North);
-        board_[c_down].AddWall(Direction::South);
-        board_[c_left].AddWall(Direction::West);
-        board_[c_right].AddWall(Direction::East);
+        values.insert(values.end(), {ball.first.x, ball.first.y, ball.second});
     }
+    return std::string(reinterpret_cast<const char *>(values.data()),
+                       values.size() * sizeof(coordinate_t));
+}
+
+} // namespace
 
-    auto walls = in.GetWalls();
-    for (auto i : walls)
+struct GameTable::DeepeningSearch
+{
+    //! \brief The Entry struct Transposition table record
+    struct Entry
     {
-        if (i.first.x == i.second.x)
-        {
-            // vertical neigbours
-            if (i.first.y < i.second.y)
-            {
-                // first is upper than second
-                board_[i.first].AddWall(Direction::South);
-                board_[i.second].AddWall(Direction::North);
-            }
-            else
-            {
-                board_[i.first].AddWall(Direction::North);
-                board_[i.second].AddWall(Direction::South);
-            }
-        }
-        else
+        size_t depth;   //!< smallest depth the state was reached at
+        bool solved;    //!< some win was found from the state at that depth
+    };
+
+    //! \brief kEntryBytes estimated memory used by table record besides
+    //! the key
+    static const size_t kEntryBytes = 64;
+
+    //! \brief rest cells where balls can stay
+    const RestCells & rest;
+
+    //! \brief order order of holes closing
+    const HoleOrder & order;
+
+    //! \brief limit maximum depth of current iteration
+    size_t limit;
+
+    //! \brief cutoff true if some node was not expanded due to the limit
+    bool cutoff;
+
+    //! \brief capacity maximum number of table records
+    size_t capacity;
+
+    //! \brief table states reached during current iteration, keyed by
+    //! rest cell of every ball
+    std::unordered_map <std::string, Entry> table;
+
+    //! \brief path keys of states of current sequence, which didn't fit to
+    //! the table. They are checked to break loops
+    std::vector <std::string> path;
+
+    //! \brief cells buffer for cells of all balls
+    std::vector <std::uint32_t> cells;
+
+    DeepeningSearch (const RestCells & r, const HoleOrder & o)
+        : rest(r), order(o), limit(0), cutoff(false), capacity(0)
+    {}
+
+    //!
+    //! \brief Key gives table key of balls positions
+    //! \param balls balls positions
+    //! \param holes number of holes in the game
+    //! \return key
+    //!
+    std::string Key (const positions_t & balls, size_t holes)
+    {
+        cells.assign(holes, rest.GetCount());
+        for (auto & ball : balls)
         {
-            // horisontal neighbours
-            if (i.first.x < i.second.x)
-            {
-                // first is left to second
-                board_[i.first].AddWall(Direction::East);
-                board_[i.second].AddWall(Direction::West);
-            }
-            else
-            {
-                board_[i.first].AddWall(Direction::West);
-                board_[i.second].AddWall(Direction::East);
-            }
+            cells[ball.second - 1] = rest.GetIndex(ball.first);
         }
+        return std::string(reinterpret_cast<const char *>(cells.data()),
+                           cells.size() * sizeof(cells[0]));
     }
+};
 
-    auto holes = in.GetHoles();
-    ball_id_t hole_id = 1;
-    for (auto i : holes)
-    {
-        board_[i].AddHole(hole_id);
-        holes_[hole_id] = i;
-        ++hole_id;
-    }
+const size_t GameTable::DeepeningSearch::kEntryBytes;
 
+GameTable::GameTable(const InputData &in)
+    : board_(std::make_shared<Board>(in))
+    , own_board_(true)
+    , search_method_(SearchMethod::Auto)
+    , max_moves_(0)
+    , visited_limit_(VisitedStates::kDefaultMemoryLimit)
+    , moves_bound_(0)
+    , solution_cache_(nullptr)
+    , cancel_(nullptr)
+    , progress_(nullptr)
+    , expand_moves_(true)
+    , solutions_ready_(true)
+{
     auto balls = in.GetBalls();
     ball_id_t ball_id = 1;
     for (auto i : balls)
@@ -114,17 +176,43 @@ GameTable::GameTable(const InputData &in)
         balls_.insert(std::make_pair(i, Ball(ball_id)));
         ++ball_id;
     }
+}
 
+GameTable::GameTable(std::shared_ptr<const Board> board,
+                     const std::vector<coordinates_t> &balls)
+    : board_(board)
+    , own_board_(false)
+    , search_method_(SearchMethod::Auto)
+    , max_moves_(0)
+    , visited_limit_(VisitedStates::kDefaultMemoryLimit)
+    , moves_bound_(0)
+    , solution_cache_(nullptr)
+    , cancel_(nullptr)
+    , progress_(nullptr)
+    , expand_moves_(true)
+    , solutions_ready_(true)
+{
+    ball_id_t ball_id = 1;
+    for (auto i : balls)
+    {
+        balls_.insert(std::make_pair(i, Ball(ball_id)));
+        ++ball_id;
+    }
 }
 
 std::map<const coordinates_t, BoardCell> GameTable::GetBoard() const
+{
+    return board_->GetCells();
+}
+
+std::shared_ptr<const Board> GameTable::GetSharedBoard() const
 {
     return board_;
 }
 
 coordinate_t GameTable::GetTableSize() const
 {
-    return table_size_;
+    return board_->GetTableSize();
 }
 
 const std::map<coordinates_t, Ball> &GameTable::GetBalls() const
@@ -132,124 +220,369 @@ const std::map<coordinates_t, Ball> &GameTable::GetBalls() const
     return balls_;
 }
 
-void GameTable::CalculateMoves()
+void GameTable::SetSolutionCache(SolutionCache *cache)
 {
-    BuildMoveGraph();
-    FindAllMoves();
+    solution_cache_ = cache;
 }
 
-std::map<const coordinates_t, GraphItem> GameTable::GetMoveGraph() const
+void GameTable::SetMaxMoves(size_t max_moves)
 {
-    return move_graph_;
+    max_moves_ = max_moves;
 }
 
-void GameTable::PrintMoves(std::ostream &os)
+void GameTable::SetSearchMethod(SearchMethod method)
+{
+    search_method_ = method;
+}
+
+void GameTable::SetVisitedMemoryLimit(size_t bytes)
+{
+    visited_limit_ = bytes;
+}
+
+void GameTable::SetCancelFlag(const std::atomic<bool> *cancel)
+{
+    cancel_ = cancel;
+}
+
+void GameTable::SetProgress(SearchProgress *progress)
+{
+    progress_ = progress;
+}
+
+void GameTable::SetExpandMoves(bool expand)
+{
+    expand_moves_ = expand;
+}
+
+void GameTable::SetTiltCacheSize(size_t size)
 {
-    for (auto move_list : moves_)
+    tilt_cache_.Resize(size);
+}
+
+input_data_t GameTable::GetPuzzleKey() const
+{
+    input_data_t balls;
+    for (auto ball : balls_)
     {
-        for (auto move : move_list)
+        ball_id_t id = ball.second.GetId();
+        if (balls.size() < id * 2)
+        {
+            balls.resize(id * 2);
+        }
+        balls[(id - 1) * 2]     = ball.first.x;
+        balls[(id - 1) * 2 + 1] = ball.first.y;
+    }
+
+    input_data_t holes;
+    for (auto hole : board_->GetHoles())
+    {
+        holes.push_back(hole.second.x);
+        holes.push_back(hole.second.y);
+    }
+
+    // walls are collected row by row, every wall is described by its
+    // western or northern cell first. Border walls are not included
+    const coordinate_t table_size = board_->GetTableSize();
+    input_data_t walls;
+    for (coordinate_t y=1; y<=table_size; ++y)
+    {
+        for (coordinate_t x=1; x<=table_size; ++x)
         {
-            if (!move.IsStartMove())
+            const BoardCell & cell = board_->GetCells().at(coordinates_t(x, y));
+            if ((x < table_size) && cell.HasWall(Direction::East))
+            {
+                walls.insert(walls.end(), {x, y, x + 1, y});
+            }
+            if ((y < table_size) && cell.HasWall(Direction::South))
             {
-                os << move.GetMove() << " ";
+                walls.insert(walls.end(), {x, y, x, y + 1});
             }
         }
-        os << "\n";
     }
+
+    input_data_t key = {table_size,
+                        static_cast<coordinate_t>(board_->GetHoles().size()),
+                        static_cast<coordinate_t>(walls.size() / 4)};
+    key.insert(key.end(), balls.begin(), balls.end());
+    key.insert(key.end(), holes.begin(), holes.end());
+    key.insert(key.end(), walls.begin(), walls.end());
+    return key;
 }
 
-void GameTable::BuildMoveGraph()
+bool GameTable::AddWall(const wall_coordinates_t &wall)
+{
+    // found moves can't be replayed on edited board
+    KeepSolutionsGame();
+    if (!EditBoard().SetWall(wall, true))
+    {
+        return false;
+    }
+    tilt_cache_.Clear();
+    return true;
+}
+
+bool GameTable::RemoveWall(const wall_coordinates_t &wall)
+{
+    KeepSolutionsGame();
+    if (!EditBoard().SetWall(wall, false))
+    {
+        return false;
+    }
+    tilt_cache_.Clear();
+    return true;
+}
+
+bool GameTable::MoveBall(ball_id_t id, const coordinates_t &to)
 {
-    //TODO: run this code in parallel, using OpenMP or Intel TBB
-    for (auto i : board_)
+    KeepSolutionsGame();
+    auto ball = std::find_if(balls_.begin(), balls_.end(),
+                             [id] (const std::pair <const coordinates_t, Ball> & item)
+    {
+        return item.second.GetId() == id;
+    });
+    if ((ball == balls_.end()) || !board_->IsOnBoard(to) ||
+        board_->GetCells().at(to).HasHole())
+    {
+        return false;
+    }
+    if (ball->first == to)
     {
-        coordinates_t cell = i.first;
-        GraphItem gi;
+        return true;
+    }
+    if (balls_.count(to) != 0)
+    {
+        return false;
+    }
 
-        FillGraphItemInDirection(gi, cell, Direction::North);
-        FillGraphItemInDirection(gi, cell, Direction::West);
-        FillGraphItemInDirection(gi, cell, Direction::South);
-        FillGraphItemInDirection(gi, cell, Direction::East);
+    // move graph doesn't depend on balls
+    Ball moved = ball->second;
+    balls_.erase(ball);
+    balls_.insert(std::make_pair(to, moved));
+    return true;
+}
 
-        move_graph_.insert(std::make_pair(cell, gi));
+bool GameTable::MoveHole(ball_id_t id, const coordinates_t &to)
+{
+    KeepSolutionsGame();
+    // board doesn't know about balls
+    if ((balls_.count(to) != 0) || !EditBoard().MoveHole(id, to))
+    {
+        return false;
     }
+    tilt_cache_.Clear();
+    return true;
 }
 
-std::pair<Ball::CollisionResult, coordinates_t>
-GameTable::RollBall(const coordinates_t &start_from,
-                    const Direction to) const
+void GameTable::CalculateMoves()
 {
-    coordinates_t current_cell = start_from;
-    coordinates_t next_cell = current_cell;
-    Ball::CollisionResult collision = Ball::CollisionResult::Pass;
-    Ball ball (INVALID_ID);
+    stats_.Reset();
 
-    do {
-        current_cell = next_cell;
-        collision = ball.CollisionWith(board_.at(current_cell), to);
+    // Rotated and mirrored copies of the game share the same cache record.
+    // It keeps solutions for canonical form of the game
+    CanonicalPuzzle canonical;
+    if (solution_cache_ != nullptr)
+    {
+        canonical = Canonicalise(GetPuzzleKey());
 
-        // If ball stands on the cell with hole during start of the move
-        // it cannot fall to the hole now. It has fallen here
-        // in previous move
-        switch (collision)
+        std::list <moves_sequence_t> solutions;
+        if (solution_cache_->Lookup(canonical.key, solutions))
         {
-        case Ball::CollisionResult::FallToHoleOrPass:
-            if (current_cell == start_from)
+            for (auto & sequence : solutions)
             {
-                collision = Ball::CollisionResult::Pass;
+                sequence = Transform(sequence, Inverse(canonical.symmetry));
             }
-            break;
-        case Ball::CollisionResult::FallToHoleOrStop:
-            if (current_cell == start_from)
+            if ((max_moves_ != 0) && !solutions.empty() &&
+                (solutions.front().size() > max_moves_))
             {
-                collision = Ball::CollisionResult::Stop;
+                // game can be won, but not in allowed number of moves
+                solutions.clear();
             }
+            SortMoves(solutions);
+            SetMoves(solutions);
+            stats_.from_cache = true;
+            return;
+        }
+    }
 
-            break;
-        case Ball::CollisionResult::Stop:
-            // fallthrough
-        case Ball::CollisionResult::Pass:
-            // nothing to do here
-            break;
+    // board builds its graph once, edits keep it up to date
+    auto start = std::chrono::steady_clock::now();
+    FindAllMoves();
+    auto search_done = std::chrono::steady_clock::now();
+
+    stats_.build_graph_us = board_->GetBuildTime();
+    stats_.search_us = std::chrono::duration_cast<std::chrono::microseconds>
+            (search_done - start).count();
+
+    if (stats_.cancelled)
+    {
+        moves_.clear();
+        return;
+    }
+
+    // Moves limit can hide solutions, so the game is known to be
+    // unsolvable only if search was not limited
+    if ((solution_cache_ != nullptr) && expand_moves_ &&
+        ((max_moves_ == 0) || !moves_.empty()))
+    {
+        std::list <moves_sequence_t> solutions = GetMoves();
+        for (auto & sequence : solutions)
+        {
+            sequence = Transform(sequence, canonical.symmetry);
+        }
+        solution_cache_->Store(canonical.key, solutions);
+    }
+}
+
+std::map<const coordinates_t, GraphItem> GameTable::GetMoveGraph() const
+{
+    return board_->GetMoveGraph();
+}
+
+void GameTable::PrintMoves(std::ostream &os)
+{
+    for (auto & move_list : moves_)
+    {
+        for (auto move : move_list)
+        {
+            os << move << " ";
         }
+        os << "\n";
+    }
+}
+
+bool GameTable::WriteMoves(MovesWriter &writer) const
+{
+    return writer.Write(moves_);
+}
+
+std::list<moves_sequence_t> GameTable::GetMoves() const
+{
+    return moves_;
+}
+
+const SolutionGraph &GameTable::GetSolutionGraph()
+{
+    BuildSolutionGraph();
+    return solutions_;
+}
 
-        next_cell = GetNeighbourCell(current_cell, to);
-    } while (collision == Ball::CollisionResult::Pass);
+size_t GameTable::GetSearchMemoryPeak() const
+{
+    return stats_.peak_bytes_reserved;
+}
+
+const SearchStats &GameTable::GetStats() const
+{
+    return stats_;
+}
 
-    return std::make_pair(collision, current_cell);
+void GameTable::SetMoves(const std::list<moves_sequence_t> &solutions)
+{
+    moves_ = solutions;
+    solutions_ready_ = false;
 }
 
-void GameTable::FillGraphItemInDirection(GraphItem &gi,
-                                         coordinates_t current_cell,
-                                         Direction move_to) const
+void GameTable::BuildSolutionGraph()
 {
-    Ball::CollisionResult collision = Ball::CollisionResult::Pass;
-    coordinates_t start_cell = current_cell;
-    coordinates_t collision_cell;
-    do {
-        auto c_result = RollBall(start_cell, move_to);
-        collision = c_result.first;
-        collision_cell = c_result.second;
-        switch (collision)
+    if (solutions_ready_)
+    {
+        return;
+    }
+    solutions_ready_ = true;
+    solutions_.Clear();
+
+    // game edited after the search, moves belong to the kept one
+    std::shared_ptr <const Board> board = std::move(solutions_board_);
+    std::map <coordinates_t, Ball> balls;
+    std::swap(balls, solutions_balls_);
+    if (moves_.empty())
+    {
+        return;
+    }
+
+    // states reached by the same number of moves are merged
+    size_t depth = moves_.front().size();
+    std::vector <std::unordered_map <std::string, std::uint32_t> > ids (depth + 1);
+    std::vector <std::vector <SolutionGraph::Edge> > edges (depth);
+    SearchStats stats = stats_;
+    if (board)
+    {
+        std::swap(board_, board);
+        std::swap(balls_, balls);
+        tilt_cache_.Clear();
+    }
+    Movement start_point = GetStartPoint();
+
+    bool replayed = true;
+
+    Arena arena;
+    {
+        ArenaScope scope (arena);
+
+        for (auto i = moves_.begin(); replayed && (i != moves_.end()); ++i)
         {
-        case Ball::CollisionResult::Pass:
-            break;
-        case Ball::CollisionResult::Stop:
-            gi.AddNeighbour(move_to, collision_cell);
-            break;
-        case Ball::CollisionResult::FallToHoleOrStop:
-            collision = Ball::CollisionResult::Stop;
-            gi.AddNeighbour(move_to, collision_cell);
-            gi.AddHole(move_to, collision_cell);
-            break;
-        case Ball::CollisionResult::FallToHoleOrPass:
-            gi.AddHole(move_to, collision_cell);
-            collision_cell = GetNeighbourCell (collision_cell, move_to);
-            break;
+            const moves_sequence_t & sequence = *i;
+            // sequences may come from the cache file, don't trust them
+            replayed = (sequence.size() == depth);
+            SearchNode * node = NewSearchNode(nullptr, Movement(start_point));
+            std::uint32_t from = 0;
+            for (size_t k = 0; replayed && (k < sequence.size()); ++k)
+            {
+                node = MakeMove(node, sequence[k]);
+                if (node == nullptr)
+                {
+                    replayed = false;
+                    break;
+                }
+                auto next = ids[k + 1].insert(std::make_pair(
+                        PositionsKey(node->state.GetBallsPositions()),
+                        static_cast<std::uint32_t>(ids[k + 1].size())));
+                edges[k].push_back({from, sequence[k], next.first->second});
+                from = next.first->second;
+            }
         }
-        start_cell = collision_cell;
+    }
+
+    if (board)
+    {
+        std::swap(board_, board);
+        std::swap(balls_, balls);
+        tilt_cache_.Clear();
+    }
+
+    stats_ = stats;
+    if (replayed)
+    {
+        solutions_.Assign(std::move(edges));
+    }
+}
+
+void GameTable::KeepSolutionsGame()
+{
+    // graph is built only if asked for, edits just keep the game for it
+    if (!solutions_ready_ && (solutions_board_ == nullptr))
+    {
+        solutions_board_ = board_;
+        solutions_balls_ = balls_;
+    }
+}
+
+Board &GameTable::EditBoard()
+{
+    if (!own_board_ || (board_.use_count() != 1))
+    {
+        board_ = std::make_shared<Board>(*board_);
+        own_board_ = true;
+    }
+    // board was created by this table as non-constant object and
+    // nobody else refers to it
+    return const_cast<Board &>(*board_);
+}
 
-    } while (collision != Ball::CollisionResult::Stop);
+void GameTable::BuildMoveGraph()
+{
+    EditBoard().BuildMoveGraph();
 }
 
 std::ostream &
@@ -387,127 +720,966 @@ operator << (std::ostream & os, const GameTable & gt)
     return os;
 }
 
-void GameTable::FindAllMoves()
+Unsolvability GameTable::CheckSolvability()
 {
-    //create a start item and start playing around
-    std::map <coordinates_t, ball_id_t> balls;
-    std::map <coordinates_t, ball_id_t> holes;
+    stats_.Reset();
 
-    for (auto ball : balls_)
+    stats_.unsolvability = CheckBalls();
+    if (stats_.unsolvability == Unsolvability::None)
     {
-        balls.insert(std::make_pair(ball.first, ball.second.GetId()));
+        HoleOrder order (FindRestCells(), board_->GetMoveGraph(), balls_,
+                         board_->GetHoles());
+        stats_.hole_dependencies = order.GetDependenciesCount();
+        stats_.unsolvability = order.GetUnsolvability();
+    }
+    return stats_.unsolvability;
+}
+
+void GameTable::FindAllMoves()
+{
+    // best solution found before the game was edited
+    moves_sequence_t previous;
+    if (!moves_.empty())
+    {
+        previous = moves_.front();
     }
-    for (auto hole : holes_)
+    moves_.clear();
+    moves_bound_ = max_moves_;
+    solutions_.Clear();
+    solutions_ready_ = false;
+    solutions_board_.reset();
+    solutions_balls_.clear();
+
+    stats_.unsolvability = CheckBalls();
+    if (stats_.unsolvability != Unsolvability::None)
     {
-        holes.insert(std::make_pair(hole.second, hole.first));
+        moves_.clear();
+        return;
+    }
+
+    RestCells rest = FindRestCells();
+    HoleOrder order (rest, board_->GetMoveGraph(), balls_, board_->GetHoles());
+    stats_.hole_dependencies = order.GetDependenciesCount();
+    stats_.unsolvability = order.GetUnsolvability();
+    if (stats_.unsolvability != Unsolvability::None)
+    {
+        moves_.clear();
+        return;
     }
 
-    Movement start_point (balls, holes);
-    std::list <Movement> moves = {start_point};
-    std::list <std::list <Movement> >all_moves  = {moves};
+    //create a start item and start playing around
+    Movement start_point = GetStartPoint();
 
-    SimulateGame(all_moves);
-}
+    // If previous best solution still wins the game, best solutions
+    // cannot be longer
+    stats_.warm_bound = previous.empty() ? 0 : ReplayMoves(start_point, previous);
+    if ((stats_.warm_bound != 0) &&
+        ((moves_bound_ == 0) || (stats_.warm_bound < moves_bound_)))
+    {
+        moves_bound_ = stats_.warm_bound;
+    }
 
+    if (search_method_ == SearchMethod::Portfolio)
+    {
+        RacePortfolio(rest);
+        return;
+    }
 
-void GameTable::SimulateGame (std::list <std::list <Movement> > & moves)
-{
-    while (!moves.empty())
+    if (search_method_ == SearchMethod::Deepening)
     {
-        std::list <Movement> & current_moves = moves.front();
+        DeepenGame(start_point, rest, order);
+        return;
+    }
 
-        if (!IsTooLotMoves(current_moves))
+    if ((search_method_ != SearchMethod::Generic) &&
+        FindAllMovesPacked(rest, order, board_->GetMoveGraph(), balls_,
+                           board_->GetHoles(),
+                           moves_bound_, visited_limit_, solutions_, stats_,
+                           cancel_, progress_))
+    {
+        solutions_ready_ = true;
+        if (expand_moves_)
         {
-            auto current_position = current_moves.back().GetBallsPositions();
-            if (current_position.size() == 0)
-            {
-                //all balls are in the holes!
-                SaveMoves(current_moves);
-            }
-            else
+            moves_ = solutions_.Expand();
+        }
+        else
+        {
+            SolutionGraph::Iterator iterator (solutions_);
+            moves_sequence_t first;
+            if (iterator.Next(first))
             {
-                std::list <Movement> to_north = MakeMove(current_moves, Direction::North);
-                std::list <Movement> to_west  = MakeMove(current_moves, Direction::West);
-                std::list <Movement> to_south = MakeMove(current_moves, Direction::South);
-                std::list <Movement> to_east  = MakeMove(current_moves, Direction::East);
-
-                if (!to_north.empty())
-                {
-                    moves.push_back(to_north);
-                }
-                if (!to_west.empty())
-                {
-                    moves.push_back(to_west);
-                }
-                if (!to_south.empty())
-                {
-                    moves.push_back(to_south);
-                }
-                if (!to_east.empty())
-                {
-                    moves.push_back(to_east);
-                }
+                moves_.push_back(first);
             }
         }
-        moves.pop_front();
+        return;
     }
+
+    SimulateGame(start_point, rest, order);
 }
 
-bool GameTable::SaveMoves (const std::list <Movement> & moves)
+bool GameTable::IsCancelled() const
 {
-    if ((moves_.size() == 0) ||
-        (moves_.back().size() == moves.size() ))
-    {
-        moves_.push_back(moves);
-        return true;
-    }
-    else if (moves_.back().size() > moves.size())
-    {
-        moves_.clear();
-        moves_.push_back(moves);
-        return true;
-    }
-    //cannot add: better moves are saved
-    return false;
+    return (cancel_ != nullptr) && cancel_->load(std::memory_order_relaxed);
 }
 
-bool GameTable::IsTooLotMoves (const std::list <Movement> & moves)
+void GameTable::ReportProgress(size_t depth)
 {
-    if ((moves_.size() == 0) ||
-        (moves_.back().size() >= moves.size() ))
+    if (progress_ != nullptr)
     {
-        return false;
+        progress_->depth.store(depth, std::memory_order_relaxed);
+        progress_->expanded.fetch_add(1, std::memory_order_relaxed);
     }
-
-    return true;
 }
 
-std::list <Movement>
-GameTable::MakeMove (std::list <Movement> & moves, Direction to)
+void GameTable::RacePortfolio(const RestCells &rest)
 {
-    auto current_position = moves.back().GetBallsPositions();
+    std::vector <SearchMethod> methods;
+    if (PackedSolver<256>::Fits(rest, board_->GetHoles().size()))
+    {
+        methods.push_back(SearchMethod::Packed);
+    }
+    methods.push_back(SearchMethod::Generic);
+    methods.push_back(SearchMethod::Deepening);
+
+    std::vector <coordinates_t> start_balls (balls_.size());
+    for (auto & ball : balls_)
+    {
+        start_balls[ball.second.GetId() - 1] = ball.first;
+    }
+
+    // All tables share this table's board, every one has its own search
+    // buffers. Losers are cancelled as soon as the winner is known
+    std::atomic <bool> race_cancel (IsCancelled());
+    std::vector <std::unique_ptr <GameTable> > tables;
+    for (auto method : methods)
+    {
+        tables.emplace_back(new GameTable(board_, start_balls));
+        tables.back()->SetSearchMethod(method);
+        tables.back()->SetMaxMoves(moves_bound_);
+        tables.back()->SetVisitedMemoryLimit(visited_limit_);
+        tables.back()->SetCancelFlag(&race_cancel);
+        // racing methods count their states together
+        tables.back()->SetProgress(progress_);
+        tables.back()->SetExpandMoves(expand_moves_);
+    }
+
+    std::mutex lock;
+    std::condition_variable finished;
+    size_t finished_count = 0;
+    size_t winner = tables.size();
+
+    std::vector <std::thread> workers;
+    for (size_t i = 0; i < tables.size(); ++i)
+    {
+        workers.push_back(std::thread([&, i] ()
+        {
+            tables[i]->CalculateMoves();
+
+            std::lock_guard <std::mutex> guard (lock);
+            if (!tables[i]->stats_.cancelled && (winner == tables.size()))
+            {
+                winner = i;
+                race_cancel = true;
+            }
+            ++finished_count;
+            finished.notify_one();
+        }));
+    }
+
+    {
+        std::unique_lock <std::mutex> guard (lock);
+        while ((winner == tables.size()) && (finished_count != tables.size()))
+        {
+            // this table may be cancelled too, its flag is not waitable
+            if (IsCancelled())
+            {
+                race_cancel = true;
+            }
+            finished.wait_for(guard, std::chrono::milliseconds(1));
+        }
+    }
+    race_cancel = true;
+    for (auto & t : workers)
+    {
+        t.join();
+    }
+
+    if (winner == tables.size())
+    {
+        stats_.cancelled = true;
+        return;
+    }
+
+    SearchStats stats = tables[winner]->stats_;
+    stats.warm_bound = stats_.warm_bound;
+    stats.winner = methods[winner];
+    stats_ = stats;
+    moves_ = tables[winner]->moves_;
+    solutions_ = tables[winner]->solutions_;
+    solutions_ready_ = tables[winner]->solutions_ready_;
+}
+
+
+Movement GameTable::GetStartPoint() const
+{
+    positions_t balls;
+    positions_t holes;
+
+    for (auto ball : balls_)
+    {
+        balls.insert(std::make_pair(ball.first, ball.second.GetId()));
+    }
+    for (auto hole : board_->GetHoles())
+    {
+        holes.insert(std::make_pair(hole.second, hole.first));
+    }
+
+    return Movement(balls, holes);
+}
+
+void GameTable::CalculateApproximateMoves(const BeamOptions &options)
+{
+    stats_.Reset();
+    stats_.approximate = true;
+    moves_.clear();
+    solutions_ready_ = false;
+    solutions_board_.reset();
+    solutions_balls_.clear();
+    moves_bound_ = max_moves_;
+
+    auto start = std::chrono::steady_clock::now();
+    stats_.build_graph_us = board_->GetBuildTime();
+
+    stats_.unsolvability = CheckBalls();
+    if (stats_.unsolvability != Unsolvability::None)
+    {
+        return;
+    }
+    RestCells rest = FindRestCells();
+    HoleOrder order (rest, board_->GetMoveGraph(), balls_, board_->GetHoles());
+    stats_.hole_dependencies = order.GetDependenciesCount();
+    stats_.unsolvability = order.GetUnsolvability();
+    if ((stats_.unsolvability != Unsolvability::None) ||
+        (options.width == 0) || (options.rollouts == 0))
+    {
+        return;
+    }
+
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (options.time_limit_ms != 0)
+    {
+        deadline = start + std::chrono::milliseconds(options.time_limit_ms);
+    }
+
+    unsigned threads = options.threads;
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (threads > options.rollouts)
+    {
+        threads = static_cast<unsigned>(options.rollouts);
+    }
+
+    std::vector <coordinates_t> start_balls (balls_.size());
+    for (auto & ball : balls_)
+    {
+        start_balls[ball.second.GetId() - 1] = ball.first;
+    }
+    Movement start_point = GetStartPoint();
+
+    std::atomic <size_t> next_rollout (0);
+    std::atomic <size_t> best_length (0);
+    std::mutex lock;
+    moves_sequence_t best;
+
+    // Every thread searches on its own table: tilts change per-table
+    // buffers and statistics. Rollouts results are compared by length,
+    // then lexicographically, so the result doesn't depend on threads
+    // timing unless time limit is hit
+    auto worker = [&] ()
+    {
+        GameTable table (board_, start_balls);
+        table.moves_bound_ = moves_bound_;
+        // states of the same depth are different, so the cache helps only
+        // when rollouts meet the same states
+        table.SetTiltCacheSize(std::min(TiltCache::kDefaultSize,
+                                        options.width * 64));
+        while (true)
+        {
+            size_t rollout = next_rollout++;
+            if ((rollout >= options.rollouts) ||
+                (std::chrono::steady_clock::now() >= deadline))
+            {
+                break;
+            }
+
+            Random random (options.seed + rollout * 0x9E3779B97F4A7C15ULL);
+            moves_sequence_t moves =
+                    table.RunBeam(start_point, rest, order, options.width,
+                                  (rollout != 0) ? &random : nullptr,
+                                  deadline, best_length);
+            ++table.stats_.rollouts;
+
+            std::lock_guard <std::mutex> guard (lock);
+            if (!moves.empty() &&
+                (best.empty() || (moves.size() < best.size()) ||
+                 ((moves.size() == best.size()) && (moves < best))))
+            {
+                best = moves;
+                best_length = best.size();
+            }
+        }
+        table.stats_.tilt_cache_hits = table.tilt_cache_.GetHits();
+        table.stats_.tilt_cache_misses = table.tilt_cache_.GetMisses();
+
+        std::lock_guard <std::mutex> guard (lock);
+        stats_.Add(table.stats_);
+    };
+
+    std::vector <std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto & t : workers)
+    {
+        t.join();
+    }
+
+    if (!best.empty())
+    {
+        moves_.push_back(best);
+    }
+    stats_.search_us = std::chrono::duration_cast<std::chrono::microseconds>
+            (std::chrono::steady_clock::now() - start).count();
+}
+
+bool GameTable::IsOptimal() const
+{
+    return !stats_.approximate;
+}
+
+moves_sequence_t
+GameTable::RunBeam(const Movement &start_point, const RestCells &rest,
+                   const HoleOrder &order, size_t width, Random *random,
+                   std::chrono::steady_clock::time_point deadline,
+                   const std::atomic<size_t> &best_length)
+{
+    // Only selected nodes of the last depth are kept. Moves sequences
+    // are restored from the steps made to every selected node
+    struct Step
+    {
+        std::uint32_t parent;   //!< index of previous node in its depth
+        Direction move;         //!< move from previous node
+    };
+    struct Candidate
+    {
+        SearchNode * node;
+        std::uint64_t score;
+        Step step;
+    };
+    std::vector <std::vector <Step> > steps;
+    std::unordered_set <std::uint64_t> visited;
+
+    std::unique_ptr <Arena> arena (new Arena());
+    std::vector <SearchNode *> beam;
+    {
+        ArenaScope scope (*arena);
+        beam.push_back(NewSearchNode(nullptr, Movement(start_point)));
+    }
+    visited.insert(HashBalls(start_point.GetBallsPositions()));
+    stats_.CountGenerated(0);
+
+    moves_sequence_t found;
+    for (size_t depth = 0; !beam.empty() && found.empty(); ++depth)
+    {
+        size_t bound = best_length;
+        if ((moves_bound_ != 0) && ((bound == 0) || (moves_bound_ < bound)))
+        {
+            bound = moves_bound_;
+        }
+        if (((bound != 0) && (depth + 1 > bound)) ||
+            (std::chrono::steady_clock::now() >= deadline))
+        {
+            break;
+        }
+
+        std::unique_ptr <Arena> next_arena (new Arena());
+        std::vector <Candidate> candidates;
+        {
+            ArenaScope scope (*next_arena);
+            for (size_t i = 0; i < beam.size(); ++i)
+            {
+                if (((i & 63) == 63) &&
+                    (std::chrono::steady_clock::now() >= deadline))
+                {
+                    break;
+                }
+                stats_.CountExpanded(depth);
+                for (auto to : {Direction::North, Direction::West,
+                                Direction::South, Direction::East})
+                {
+                    SearchNode * node = MakeMove(beam[i], to);
+                    if (node == nullptr)
+                    {
+                        continue;
+                    }
+                    const positions_t & balls = node->state.GetBallsPositions();
+                    if (IsDead(order, rest, balls))
+                    {
+                        ++stats_.dead_rejections;
+                        continue;
+                    }
+                    if (!visited.insert(HashBalls(balls)).second)
+                    {
+                        ++stats_.visited_rejections;
+                        continue;
+                    }
+                    stats_.CountGenerated(depth + 1);
+
+                    Step step {static_cast<std::uint32_t>(i), to};
+                    if (balls.empty())
+                    {
+                        // all balls are in the holes: restore the moves
+                        moves_sequence_t moves (1, to);
+                        for (size_t d = depth; d > 0; --d)
+                        {
+                            const Step & previous = steps[d - 1][step.parent];
+                            moves.push_back(previous.move);
+                            step.parent = previous.parent;
+                        }
+                        std::reverse(moves.begin(), moves.end());
+                        if (found.empty() || (moves < found))
+                        {
+                            found = moves;
+                        }
+                        continue;
+                    }
+
+                    // distance estimation is rough: random part lets
+                    // different searches keep different states
+                    std::uint64_t score = EstimateDistance(balls) * 4;
+                    if (random != nullptr)
+                    {
+                        score += random->Next(8);
+                    }
+                    candidates.push_back(Candidate {node, score, step});
+                }
+            }
+        }
+        stats_.peak_frontier = std::max(stats_.peak_frontier, candidates.size());
+        stats_.peak_bytes_reserved = std::max(stats_.peak_bytes_reserved,
+                                              arena->GetBytesReserved() +
+                                              next_arena->GetBytesReserved());
+        stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use,
+                                            arena->GetBytesInUse() +
+                                            next_arena->GetBytesInUse());
+
+        // the best states are kept in the order they were generated
+        auto better = [] (const Candidate & l, const Candidate & r)
+        {
+            return (l.score < r.score) ||
+                   ((l.score == r.score) &&
+                    ((l.step.parent < r.step.parent) ||
+                     ((l.step.parent == r.step.parent) && (l.step.move < r.step.move))));
+        };
+        if (candidates.size() > width)
+        {
+            std::nth_element(candidates.begin(), candidates.begin() + width,
+                             candidates.end(), better);
+            candidates.resize(width);
+        }
+
+        beam.clear();
+        steps.emplace_back();
+        for (auto & candidate : candidates)
+        {
+            beam.push_back(candidate.node);
+            steps.back().push_back(candidate.step);
+        }
+        // nodes of previous depth are not needed anymore
+        arena = std::move(next_arena);
+    }
+    return found;
+}
+
+std::uint64_t GameTable::EstimateDistance(const positions_t &balls) const
+{
+    // ball which cannot reach its hole alone needs some other ball to
+    // stop it, count it as a long way
+    const std::uint64_t unreachable = 2 * board_->GetTableSize();
+    std::uint64_t distance = 0;
+    for (auto & ball : balls)
+    {
+        std::uint32_t d = board_->GetDistance(ball.second, ball.first);
+        distance += (d != Board::kUnreachable) ? d : unreachable;
+    }
+    return distance;
+}
+
+Unsolvability GameTable::CheckBalls()
+{
+    const move_graph_t & graph = board_->GetMoveGraph();
+    stats_.frozen_balls = FindFrozenBalls(graph, balls_).size();
+    if (stats_.frozen_balls != 0)
+    {
+        // frozen ball never gets to its hole
+        return Unsolvability::FrozenBall;
+    }
+    if (FindSeparatedBall(graph, balls_, board_->GetHoles()) != INVALID_ID)
+    {
+        return Unsolvability::SeparatedHole;
+    }
+    return Unsolvability::None;
+}
+
+RestCells GameTable::FindRestCells() const
+{
+    std::vector <coordinates_t> starts;
+    for (auto & ball : balls_)
+    {
+        starts.push_back(ball.first);
+    }
+    return RestCells(board_->GetTableSize(), board_->GetMoveGraph(), starts);
+}
+
+void GameTable::SimulateGame (const Movement & start_point, const RestCells & rest,
+                              const HoleOrder & order)
+{
+    // Every state is kept until the end of the search: it is a part
+    // of moves sequences passing through it. So all the states and their
+    // containers are released at once together with arena
+    tilt_cache_.Clear();
+
+    // Nodes reached at the same depth are all kept: they are parts of
+    // different moves sequences. But state reached at smaller depth
+    // cannot be a part of the best sequence
+    StateRanker ranker (rest.GetCount(), board_->GetHoles().size());
+    VisitedStates visited;
+    std::vector <std::uint32_t> cells;
+    if (visited.Reset(ranker.GetSpaceSize(), 2, visited_limit_))
+    {
+        visited.Visit(RankState(ranker, rest, start_point.GetBallsPositions(), cells));
+        stats_.visited_bytes = visited.GetBytes();
+    }
+    size_t depth = 0;
+
+    Arena arena;
+    {
+        ArenaScope scope (arena);
+
+        std::deque <SearchNode *, ArenaAllocator <SearchNode *> > nodes;
+        nodes.push_back(NewSearchNode(nullptr, Movement(start_point)));
+        stats_.CountGenerated(0);
+
+        while (!nodes.empty())
+        {
+            if (IsCancelled())
+            {
+                stats_.cancelled = true;
+                break;
+            }
+
+            SearchNode * current_node = nodes.front();
+            nodes.pop_front();
+
+            if (visited.IsEnabled() && (current_node->depth != depth))
+            {
+                // all nodes of the next depth are generated
+                visited.NextDepth();
+                depth = current_node->depth;
+            }
+
+            if (IsTooLotMoves(current_node->depth))
+            {
+                continue;
+            }
+
+            if (current_node->state.GetBallsPositions().size() == 0)
+            {
+                //all balls are in the holes!
+                SaveMoves(current_node);
+                continue;
+            }
+
+            if (IsTooLotMoves(current_node->depth + 1))
+            {
+                // next states are too far
+                continue;
+            }
+
+            stats_.CountExpanded(current_node->depth);
+            ReportProgress(current_node->depth);
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                SearchNode * new_node = MakeMove(current_node, to);
+                if ((new_node != nullptr) &&
+                    IsDead(order, rest, new_node->state.GetBallsPositions()))
+                {
+                    ++stats_.dead_rejections;
+                    new_node = nullptr;
+                }
+                if ((new_node != nullptr) && visited.IsEnabled())
+                {
+                    std::uint64_t rank = RankState(ranker, rest,
+                                                   new_node->state.GetBallsPositions(),
+                                                   cells);
+                    if (visited.IsVisited(rank))
+                    {
+                        ++stats_.visited_rejections;
+                        new_node = nullptr;
+                    }
+                    else
+                    {
+                        visited.VisitNext(rank);
+                    }
+                }
+                if (new_node != nullptr)
+                {
+                    stats_.CountGenerated(new_node->depth);
+                    nodes.push_back(new_node);
+                }
+            }
+            if (nodes.size() > stats_.peak_frontier)
+            {
+                stats_.peak_frontier = nodes.size();
+            }
+        }
+    }
+    stats_.peak_bytes_reserved = arena.GetPeakBytesReserved();
+    stats_.peak_bytes_in_use = arena.GetPeakBytesInUse();
+    stats_.tilt_cache_hits = tilt_cache_.GetHits();
+    stats_.tilt_cache_misses = tilt_cache_.GetMisses();
+}
+
+void GameTable::DeepenGame(const Movement &start_point, const RestCells &rest,
+                           const HoleOrder &order)
+{
+    tilt_cache_.Clear();
+
+    DeepeningSearch search (rest, order);
+    size_t holes = board_->GetHoles().size();
+    search.capacity = visited_limit_ /
+            (holes * sizeof(std::uint32_t) + DeepeningSearch::kEntryBytes);
+
+    Arena arena;
+    {
+        ArenaScope scope (arena);
+
+        SearchNode * root = NewSearchNode(nullptr, Movement(start_point));
+        stats_.CountGenerated(0);
+        std::string root_key = search.Key(root->state.GetBallsPositions(), holes);
+
+        // Every iteration repeats all the previous ones, but it is cheap
+        // comparing to the last one: search tree grows exponentially
+        for (search.limit = 1; ; ++search.limit)
+        {
+            if ((moves_bound_ != 0) && (search.limit > moves_bound_))
+            {
+                break;
+            }
+
+            search.table.clear();
+            search.path.clear();
+            search.cutoff = false;
+            if (search.capacity != 0)
+            {
+                search.table[root_key] = {0, false};
+            }
+            else
+            {
+                search.path.push_back(root_key);
+            }
+
+            bool won = DeepenFrom(root, search);
+            stats_.visited_bytes = std::max(stats_.visited_bytes,
+                    search.table.size() * (root_key.size() + DeepeningSearch::kEntryBytes));
+            if (won || stats_.cancelled)
+            {
+                break;
+            }
+
+            // Node may be cut off at the limit though its state is reached
+            // by shorter sequence too. So if all the states are in the
+            // table, next iteration is needed only if some state is
+            // reached not earlier than at the limit
+            bool deeper = search.cutoff;
+            if (search.table.size() < search.capacity)
+            {
+                deeper = std::any_of(search.table.begin(), search.table.end(),
+                                     [&search] (const std::pair <const std::string,
+                                                DeepeningSearch::Entry> & entry)
+                {
+                    return entry.second.depth == search.limit;
+                });
+            }
+            if (!deeper)
+            {
+                break;
+            }
+        }
+    }
+    stats_.peak_bytes_reserved = arena.GetPeakBytesReserved();
+    stats_.peak_bytes_in_use = arena.GetPeakBytesInUse();
+    stats_.tilt_cache_hits = tilt_cache_.GetHits();
+    stats_.tilt_cache_misses = tilt_cache_.GetMisses();
+}
+
+bool GameTable::DeepenFrom(SearchNode *node, DeepeningSearch &search)
+{
+    if (node->depth == search.limit)
+    {
+        search.cutoff = true;
+        return false;
+    }
+
+    bool won = false;
+    stats_.CountExpanded(node->depth);
+    ReportProgress(node->depth);
+    for (auto to : {Direction::North, Direction::West,
+                    Direction::South, Direction::East})
+    {
+        if (IsCancelled())
+        {
+            stats_.cancelled = true;
+            return false;
+        }
+
+        SearchNode * new_node = MakeMove(node, to);
+        if (new_node == nullptr)
+        {
+            continue;
+        }
+        const positions_t & balls = new_node->state.GetBallsPositions();
+        if (balls.empty())
+        {
+            // wins can't be shorter than the limit, they were found
+            // by previous iterations then
+            stats_.CountGenerated(new_node->depth);
+            won = SaveMoves(new_node) || won;
+            DeleteSearchNode(new_node);
+            continue;
+        }
+        if (IsDead(search.order, search.rest, balls))
+        {
+            ++stats_.dead_rejections;
+            DeleteSearchNode(new_node);
+            continue;
+        }
+
+        // State reached at smaller depth can't be a part of the best
+        // sequence. State reached at the same depth is searched again only
+        // if it leads to the win: sequences through it are the best too
+        std::string key = search.Key(balls, board_->GetHoles().size());
+        bool in_path = false;
+        auto entry = search.table.find(key);
+        if (entry != search.table.end())
+        {
+            if ((entry->second.depth < new_node->depth) ||
+                ((entry->second.depth == new_node->depth) && !entry->second.solved))
+            {
+                ++stats_.visited_rejections;
+                DeleteSearchNode(new_node);
+                continue;
+            }
+            if (entry->second.depth > new_node->depth)
+            {
+                entry->second = {new_node->depth, false};
+            }
+        }
+        else if (search.table.size() < search.capacity)
+        {
+            search.table[key] = {new_node->depth, false};
+        }
+        else if (std::find(search.path.begin(), search.path.end(), key) !=
+                 search.path.end())
+        {
+            // table is full, but the loop is still broken
+            ++stats_.visited_rejections;
+            DeleteSearchNode(new_node);
+            continue;
+        }
+        else
+        {
+            search.path.push_back(key);
+            in_path = true;
+        }
+
+        stats_.CountGenerated(new_node->depth);
+        if (DeepenFrom(new_node, search))
+        {
+            won = true;
+            entry = search.table.find(key);
+            if (entry != search.table.end())
+            {
+                entry->second.solved = true;
+            }
+        }
+        if (in_path)
+        {
+            search.path.pop_back();
+        }
+        DeleteSearchNode(new_node);
+    }
+    return won;
+}
+
+GameTable::SearchNode *
+GameTable::NewSearchNode(const SearchNode *parent, Movement &&state)
+{
+    // Nodes are never destroyed: all their memory is owned by arena
+    void * memory = Arena::GetCurrent()->Allocate(sizeof(SearchNode));
+    size_t depth = (parent != nullptr) ? parent->depth + 1 : 0;
+    return new (memory) SearchNode {parent, depth, std::move(state)};
+}
+
+void GameTable::DeleteSearchNode(SearchNode *node)
+{
+    node->~SearchNode();
+    Arena::GetCurrent()->Deallocate(node, sizeof(SearchNode));
+}
+
+std::uint64_t GameTable::RankState(const StateRanker &ranker,
+                                   const RestCells &rest,
+                                   const positions_t &balls,
+                                   std::vector<std::uint32_t> &cells) const
+{
+    cells.assign(board_->GetHoles().size(), ranker.GetRemovedCell());
+    for (auto & ball : balls)
+    {
+        cells[ball.second - 1] = rest.GetIndex(ball.first);
+    }
+    return ranker.Rank(cells);
+}
+
+bool GameTable::SaveMoves (const SearchNode * node)
+{
+    if (moves_.size() != 0)
+    {
+        if (moves_.back().size() < node->depth)
+        {
+            //cannot add: better moves are saved
+            return false;
+        }
+        if (moves_.back().size() > node->depth)
+        {
+            moves_.clear();
+        }
+    }
+
+    moves_sequence_t moves;
+    moves.reserve(node->depth);
+    for (const SearchNode * i = node; i->parent != nullptr; i = i->parent)
+    {
+        moves.push_back(i->state.GetMove());
+    }
+    std::reverse(moves.begin(), moves.end());
+
+    moves_.push_back(moves);
+    return true;
+}
+
+bool GameTable::IsDead(const HoleOrder &order, const RestCells &rest,
+                       const positions_t &balls)
+{
+    for (auto & ball : balls)
+    {
+        if (order.IsDead(ball.second, rest.GetIndex(ball.first)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t GameTable::ReplayMoves(const Movement &start_point,
+                              const moves_sequence_t &moves)
+{
+    SearchStats stats = stats_;
+    size_t won = 0;
+
+    Arena arena;
+    {
+        ArenaScope scope (arena);
+
+        SearchNode * node = NewSearchNode(nullptr, Movement(start_point));
+        for (auto to : moves)
+        {
+            node = MakeMove(node, to);
+            if (node == nullptr)
+            {
+                break;
+            }
+            if (node->state.GetBallsPositions().empty())
+            {
+                won = node->depth;
+                break;
+            }
+        }
+    }
+
+    stats_ = stats;
+    return won;
+}
+
+bool GameTable::IsTooLotMoves (size_t moves_count)
+{
+    if ((moves_bound_ != 0) && (moves_count > moves_bound_))
+    {
+        return true;
+    }
+
+    if ((moves_.size() == 0) ||
+        (moves_.back().size() >= moves_count ))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+GameTable::SearchNode *
+GameTable::MakeMove (SearchNode * node, Direction to)
+{
+    const positions_t & current_position = node->state.GetBallsPositions();
     if (current_position.size() == 0)
     {
         //all balls are in the holes! no need to proceed making moves
-        SaveMoves(moves);
-        return std::list <Movement> ();
+        return nullptr;
     }
 
-    std::map <coordinates_t, ball_id_t> new_position;
-    std::map <coordinates_t, ball_id_t> new_position_removed_balls;
-    bool game_ok = RollAllBalls (to,
-                                 current_position,
-                                 moves.back().GetHoles(),
-                                 new_position,
-                                 new_position_removed_balls);
+    positions_t new_position;
+    positions_t new_position_removed_balls;
+    bool game_ok = true;
+    if (!tilt_cache_.Lookup(to, current_position, node->state.GetHoles(),
+                            new_position, new_position_removed_balls, game_ok))
+    {
+        game_ok = RollAllBalls (to,
+                                current_position,
+                                node->state.GetHoles(),
+                                new_position,
+                                new_position_removed_balls);
+        tilt_cache_.Store(new_position, new_position_removed_balls, game_ok);
+    }
     if (!game_ok)
     {
-        return std::list <Movement> ();
+        ++stats_.wrong_hole_failures;
+        return nullptr;
     }
 
-    moves.back().InitLoopGuard();
+    if (new_position_removed_balls.empty() && (new_position == current_position))
+    {
+        // nothing has moved: state is the same and cannot lead
+        // to shorter moves sequence
+        ++stats_.duplicate_rejections;
+        return nullptr;
+    }
 
-    Movement new_move (to, moves.back());
+    Movement new_move (to, node->state);
+    new_move.LiftBalls();
     for (auto ball : new_position_removed_balls)
     {
         for (auto previous : current_position )
@@ -516,7 +1688,8 @@ GameTable::MakeMove (std::list <Movement> & moves, Direction to)
             {
                 if (!new_move.SetBallPosition(ball.second, ball.first, previous.first))
                 {
-                    return std::list <Movement> ();
+                    ++stats_.collision_rejections;
+                    return nullptr;
                 }
                 break;
             }
@@ -530,89 +1703,113 @@ GameTable::MakeMove (std::list <Movement> & moves, Direction to)
             {
                 if (!new_move.SetBallPosition(ball.second, ball.first, previous.first))
                 {
-                    return std::list <Movement> ();
+                    ++stats_.collision_rejections;
+                    return nullptr;
                 }
                 break;
             }
         }
     }
 
-    if (new_move.IsLooped())
-    {
-        return std::list <Movement> ();
-    }
-
-    std::list <Movement> new_moves_list (moves);
-    new_moves_list.push_back(new_move);
-    return new_moves_list;
+    return NewSearchNode(node, std::move(new_move));
 }
 
 
 bool GameTable::RollAllBalls (Direction to,
-                              const std::map <coordinates_t, ball_id_t> & current_position,
-                              std::map <coordinates_t, ball_id_t> open_holes,
-                              std::map <coordinates_t, ball_id_t> & new_position,
-                              std::map <coordinates_t, ball_id_t> & new_position_removed)
+                              const positions_t & current_position,
+                              const positions_t & open_holes,
+                              positions_t & new_position,
+                              positions_t & new_position_removed)
 {
-    coordinate_t begin;
-    coordinate_t end;
-    bool x_before_y;
-
     switch (to)
     {
     case Direction::North:
-        begin = 1;
-        end   = table_size_;
-        x_before_y = false;
-        break;
+        return RollAllBalls<Direction::North>(current_position, open_holes,
+                                              new_position, new_position_removed);
     case Direction::West:
-        begin = 1;
-        end   = table_size_;
-        x_before_y = true;
-        break;
+        return RollAllBalls<Direction::West>(current_position, open_holes,
+                                             new_position, new_position_removed);
     case Direction::South:
-        begin = table_size_;
-        end   = 1;
-        x_before_y = false;
-        break;
+        return RollAllBalls<Direction::South>(current_position, open_holes,
+                                              new_position, new_position_removed);
     case Direction::East:
-        begin = table_size_;
-        end   = 1;
-        x_before_y = true;
-        break;
+        return RollAllBalls<Direction::East>(current_position, open_holes,
+                                             new_position, new_position_removed);
+    }
+    return false;
+}
+
+template <Direction To>
+bool GameTable::RollAllBalls (const positions_t & current_position,
+                              const positions_t & open_holes,
+                              positions_t & new_position,
+                              positions_t & new_position_removed)
+{
+    const move_graph_t & graph = board_->GetMoveGraph();
+    const std::map <ball_id_t, coordinates_t> & holes = board_->GetHoles();
+
+    // last stop in every line touched by the tilt
+    if (line_stops_.size() <= board_->GetTableSize())
+    {
+        line_stops_.resize(board_->GetTableSize() + 1);
+    }
+    for (auto & ball : current_position)
+    {
+        line_stops_[GetLine<To>(ball.first)] = coordinates_t();
     }
 
-    for (coordinate_t i=begin; IsValid(i, table_size_); (begin < end) ? ++i : --i)
+    // ids of holes are 1..K, so all of them fit to the mask or none
+    bool use_hole_mask = (holes.size() <= kMaxMaskedHoleId);
+    hole_mask_t open_mask = 0;
+    positions_t still_open_holes;
+    if (use_hole_mask)
     {
-        for (coordinate_t j=begin; IsValid(j, table_size_); (begin < end) ? ++j : --j)
+        for (auto & hole : open_holes)
         {
-            coordinates_t current_cell = (x_before_y) ? coordinates_t (i, j)
-                                                      : coordinates_t (j, i);
+            open_mask |= HoleBit(hole.second);
+        }
+    }
+    else
+    {
+        still_open_holes = open_holes;
+    }
 
-            ball_id_t ball;
-            auto ball_iterator = current_position.find(current_cell);
-            if (ball_iterator == current_position.end())
-            {
-                //no ball here
-                continue;
-            }
-            else
+    // Balls are ordered by column, then by row. So they are already sorted
+    // in the order they should roll in: every column is sorted north to
+    // south and every row is sorted west to east. Balls from other lines
+    // never meet each other, so the order between lines doesn't matter
+    auto roll = [&] (const coordinates_t & current_cell, ball_id_t ball)
+    {
+        const GraphItem & graph_item = graph.at(current_cell);
+        coordinates_t next_hop = graph_item.GetNeigbour<To>();
+        bool reach_gap = false;
+
+        // ball can fall into the hole while movig
+        // if hole id and ball's one dont match game lost,
+        // otherwize ball in its hole and we are on our way to win
+        if (use_hole_mask)
+        {
+            ball_id_t hole = graph_item.FirstOpenHole(To, open_mask);
+            if (hole != INVALID_ID)
             {
-                ball = ball_iterator->second;
+                if (hole != ball)
+                {
+                    // Game over
+                    return false;
+                }
+                next_hop = holes.at(hole);
+                reach_gap = true;
+                // block hole for next balls
+                open_mask &= ~HoleBit(hole);
             }
-
-            coordinates_t next_hop = move_graph_.at(current_cell).GetNeigbour(to);
-            auto gaps_on_road = move_graph_.at(current_cell).GetHolesOnWayTo(to);
-            bool reach_gap = false;
-
-            // ball can fall into the hole while movig
-            // if hole id and ball's one dont match game lost,
-            // otherwize ball in its hole and we are on our way to win
-            for (auto gap : gaps_on_road)
+        }
+        else
+        {
+            for (auto & gap : graph_item.GetHolesOnWayTo(To))
             {
                 //is gap open?
-                auto hole = open_holes.find(gap);
-                if (hole != open_holes.end())
+                auto hole = still_open_holes.find(gap);
+                if (hole != still_open_holes.end())
                 {
                     if (hole->second == ball)
                     {
@@ -620,7 +1817,7 @@ bool GameTable::RollAllBalls (Direction to,
                         next_hop = hole->first;
                         reach_gap = true;
                         // block hole for next balls
-                        open_holes.erase(hole);
+                        still_open_holes.erase(hole);
                         break;
                     }
                     else
@@ -630,30 +1827,46 @@ bool GameTable::RollAllBalls (Direction to,
                     }
                 }
             }
-            //todo several balls in one cell!!!
+        }
 
-            // is cell empty?
-            if (!reach_gap)
-            {
-                // cell can be occupied
-                coordinates_t destination=next_hop;
-                while ( (new_position.find(destination) != new_position.end()) &&
-                        (destination != GetNeighbourCell(current_cell, ReverseDirection(to))) )
-                {
-                    destination = GetNeighbourCell(destination, ReverseDirection(to));
-                }
-                next_hop = destination;
-            }
+        // set new ball position
+        if (reach_gap)
+        {
+            new_position_removed.insert(std::make_pair(next_hop, ball));
+            return true;
+        }
 
-            // set new ball position
-            if (reach_gap)
+        // Balls ahead in the line are stacked one after another behind
+        // their stop cell. If ball stops at the stack it stands right
+        // behind the last ball of the stack
+        coordinates_t & line_stop = line_stops_[GetLine<To>(current_cell)];
+        if ((line_stop != coordinates_t()) && IsNotBehind<To>(next_hop, line_stop))
+        {
+            next_hop = GetNeighbourCell<DirectionTraits<To>::kReverse>(line_stop);
+        }
+        line_stop = next_hop;
+
+        new_position.insert(std::make_pair(next_hop, ball));
+        return true;
+    };
+
+    if (DirectionTraits<To>::kStep > 0)
+    {
+        for (auto ball = current_position.rbegin(); ball != current_position.rend(); ++ball)
+        {
+            if (!roll(ball->first, ball->second))
             {
-                new_position_removed.insert(std::make_pair(next_hop, ball));
+                return false;
             }
-            else
+        }
+    }
+    else
+    {
+        for (auto & ball : current_position)
+        {
+            if (!roll(ball.first, ball.second))
             {
-                new_position.insert(std::make_pair(next_hop, ball));
-
+                return false;
             }
         }
     }
@@ -37,14 +37,55 @@
 #include <string>
 #include <map>
 #include <list>
+#include <memory>
+#include <atomic>
+#include <chrono>
 
 #include "tg_types.h"
 #include "cell_object.h"
 #include "input.h"
 #include "board_cell.h"
+#include "board.h"
 #include "ball.h"
 #include "move_graph.h"
 #include "movement.h"
+#include "moves_writer.h"
+#include "solution_cache.h"
+#include "solution_graph.h"
+#include "analysis.h"
+#include "rest_cells.h"
+#include "search_stats.h"
+#include "state_rank.h"
+#include "tilt_cache.h"
+
+//!
+//! \brief The BeamOptions struct Parameters of approximate search, see
+//! %GameTable::CalculateApproximateMoves()
+//!
+struct BeamOptions
+{
+    //! \brief width number of states kept at every depth
+    size_t width;
+
+    //! \brief rollouts number of beam searches. First one is deterministic,
+    //! others break ties between equally good states randomly
+    size_t rollouts;
+
+    //! \brief threads number of threads, 0 for number of CPUs
+    unsigned threads;
+
+    //! \brief time_limit_ms time limit of the search, 0 if unlimited.
+    //! Best moves found before the limit are kept
+    std::uint64_t time_limit_ms;
+
+    //! \brief seed base seed of random tie breaking
+    std::uint64_t seed;
+
+    BeamOptions ()
+        : width(256), rollouts(8), threads(0), time_limit_ms(0), seed(1) {}
+};
+
+class Random;
 
 //!
 //! \brief The GameTable class Contains description of game state. Looking for
@@ -59,8 +100,90 @@ public:
     //! \param in input data
     //!
     GameTable (const InputData & in);
+
+    //!
+    //! \brief GameTable Create game table on the board shared with other
+    //! tables. Board is not copied until the table edits it, many tables
+    //! may solve their games on the same board simultaneously.
+    //! Input errors must be handled outside of this class
+    //! \param board game board
+    //! \param balls start positions of balls, ball id is position index + 1
+    //!
+    GameTable (std::shared_ptr <const Board> board,
+               const std::vector <coordinates_t> & balls);
     ~GameTable() = default;
 
+    //!
+    //! \brief SetSolutionCache attach persistent cache of solved games.
+    //! %CalculateMoves() will look for solutions in cache before search
+    //! and store found solutions there. Cache must outlive game table
+    //! \param cache solutions cache, nullptr to detach
+    //!
+    void SetSolutionCache (SolutionCache * cache);
+
+    //!
+    //! \brief SetMaxMoves limit length of moves sequences. If game cannot
+    //! be won in this number of moves, no moves will be found
+    //! \param max_moves maximum number of moves, 0 for unlimited search
+    //!
+    void SetMaxMoves (size_t max_moves);
+
+    //!
+    //! \brief SetTiltCacheSize change number of tilt results remembered
+    //! during search
+    //! \param size number of cache slots, 0 disables the cache
+    //!
+    void SetTiltCacheSize (size_t size);
+
+    //!
+    //! \brief SetSearchMethod choose how best moves are searched. All
+    //! methods find the same moves, but collect different statistics
+    //! \param method search method
+    //!
+    void SetSearchMethod (SearchMethod method);
+
+    //!
+    //! \brief SetVisitedMemoryLimit limit memory of visited states bitmap.
+    //! States are ranked and tracked by bitmap if it fits to the limit
+    //! \param bytes memory limit, 0 disables visited states tracking
+    //!
+    void SetVisitedMemoryLimit (size_t bytes);
+
+    //!
+    //! \brief SetCancelFlag let other thread stop the search. Flag is polled
+    //! by search loops, when it is raised search stops as soon as possible,
+    //! no moves are found and %SearchStats::cancelled is set. Flag must
+    //! outlive the search
+    //! \param cancel cancellation flag, nullptr if search is never cancelled
+    //!
+    void SetCancelFlag (const std::atomic <bool> * cancel);
+
+    //!
+    //! \brief SetProgress publish progress of the search, so it can be
+    //! polled from other thread. Progress must outlive the search
+    //! \param progress progress counters, nullptr if not needed
+    //!
+    void SetProgress (SearchProgress * progress);
+
+    //!
+    //! \brief SetExpandMoves choose if all the best moves sequences are
+    //! listed. Packed search finds the graph of sequences, listing them may
+    //! take much longer than the search. When listing is disabled
+    //! %GetMoves() gives only the first sequence, all of them are in
+    //! %GetSolutionGraph(), and found moves are not stored to solutions
+    //! cache. Enabled by default
+    //! \param expand true to list all the sequences
+    //!
+    void SetExpandMoves (bool expand);
+
+    //!
+    //! \brief GetPuzzleKey gives normalised description of the game in input
+    //! data format: walls are described in the same order and direction
+    //! no matter how they were set in input data
+    //! \return puzzle key
+    //!
+    input_data_t GetPuzzleKey () const;
+
     //!
     //! \brief GetBoard gives representation of game board: cells with their
     //! walls and holes
@@ -68,6 +191,12 @@ public:
     //!
     std::map<const coordinates_t, BoardCell> GetBoard() const;
 
+    //!
+    //! \brief GetSharedBoard gives game board to be shared with other tables
+    //! \return game board
+    //!
+    std::shared_ptr <const Board> GetSharedBoard () const;
+
     //!
     //! \brief GetTableSize Gives size of game board table
     //! \return game board size
@@ -80,12 +209,78 @@ public:
     //!
     const std::map <coordinates_t, Ball> & GetBalls() const;
 
+    //!
+    //! \brief AddWall put wall between two neighbour cells. Only the row or
+    //! the column of the wall is rebuilt in move graph. Shared board is
+    //! copied before the first edit
+    //! \param wall wall position
+    //! \return false if cells are not neighbours on the board
+    //!
+    bool AddWall (const wall_coordinates_t & wall);
+
+    //!
+    //! \brief RemoveWall remove wall between two neighbour cells, border
+    //! walls cannot be removed. Only the row or the column of the wall is
+    //! rebuilt in move graph
+    //! \param wall wall position
+    //! \return false if cells are not neighbours on the board
+    //!
+    bool RemoveWall (const wall_coordinates_t & wall);
+
+    //!
+    //! \brief MoveBall move ball to other cell. Move graph is not changed
+    //! \param id ball id
+    //! \param to new ball position
+    //! \return false if there is no such ball or the cell is out of board,
+    //! holds other ball or some hole
+    //!
+    bool MoveBall (ball_id_t id, const coordinates_t & to);
+
+    //!
+    //! \brief MoveHole move hole to other cell. Only rows and columns of
+    //! old and new hole positions are rebuilt in move graph
+    //! \param id hole id
+    //! \param to new hole position
+    //! \return false if there is no such hole or the cell is out of board,
+    //! holds other hole or some ball
+    //!
+    bool MoveHole (ball_id_t id, const coordinates_t & to);
+
     //!
     //! \brief CalculateMoves calculate moves based on initial board and balls
-    //! state. Must be called manually
+    //! state. Must be called manually. If the game was solved before, best
+    //! solution found then is tried first: if it still wins the game after
+    //! edits, the search is not done deeper than this solution
     //!
     void CalculateMoves ();
 
+    //!
+    //! \brief CalculateApproximateMoves look for some moves sequence to win
+    //! the game, when exact search is too slow. Several beam searches run in
+    //! parallel: at every depth only states closest to win are kept,
+    //! distance is estimated by %Board::GetDistance(). Found sequence is the
+    //! shortest one among all beam searches, but it is not guaranteed to be
+    //! the shortest one for the game, see %IsOptimal(). Solutions cache is
+    //! not used
+    //! \param options search parameters
+    //!
+    void CalculateApproximateMoves (const BeamOptions & options);
+
+    //!
+    //! \brief IsOptimal check if moves are known to be the best ones
+    //! \return false if moves were found by %CalculateApproximateMoves()
+    //!
+    bool IsOptimal () const;
+
+    //!
+    //! \brief CheckSolvability look for the reason why game cannot be won
+    //! without search. Only necessary conditions are checked, so the game
+    //! may be unsolvable even if no reason is found. The same checks are
+    //! done by %CalculateMoves() before search
+    //! \return reason, %Unsolvability::None if game may be solvable
+    //!
+    Unsolvability CheckSolvability ();
+
     //!
     //! \brief GetMoveGraph gives representation of internal move graph
     //! \return return move graph
@@ -98,78 +293,329 @@ public:
     //!
     void PrintMoves (std::ostream & os);
 
+    //!
+    //! \brief WriteMoves write moves sequences to win in this game in the
+    //! same form as %PrintMoves() does, but without streams
+    //! \param writer buffered writer
+    //! \return false on write error
+    //!
+    bool WriteMoves (MovesWriter & writer) const;
+
+    //!
+    //! \brief GetMoves gives best moves sequences found by %CalculateMoves()
+    //! \return best moves sequences, empty if game cannot be won
+    //!
+    std::list <moves_sequence_t> GetMoves () const;
+
+    //!
+    //! \brief GetSolutionGraph gives graph of the best moves sequences
+    //! found by last search. Graph is built from found sequences on the
+    //! first request, unless search has found it itself
+    //! \return solutions graph, empty if game cannot be won or found
+    //! sequences cannot be replayed on the table
+    //!
+    const SolutionGraph & GetSolutionGraph ();
+
+    //!
+    //! \brief GetSearchMemoryPeak gives peak size of memory used to store
+    //! search states by last %CalculateMoves() call
+    //! \return size in bytes
+    //!
+    size_t GetSearchMemoryPeak () const;
+
+    //!
+    //! \brief GetStats gives statistics of last %CalculateMoves() or
+    //! %CheckSolvability() call
+    //! \return search statistics
+    //!
+    const SearchStats & GetStats () const;
+
 protected:
-    //! \brief board_ initial board state
-    std::map <const coordinates_t, BoardCell> board_;
+    //! \brief board_ game board, may be shared with other tables
+    std::shared_ptr <const Board> board_;
+
+    //! \brief own_board_ true if board_ was created by this table, so it
+    //! can be edited in place while no other table shares it
+    bool own_board_;
 
     //! \brief balls_ initial position of balls
     std::map <coordinates_t, Ball> balls_;
 
-    //! \brief move_graph_ get move move graph builded based on initial board
-    //! state
-    std::map <const coordinates_t, GraphItem> move_graph_;
+    //! \brief moves_ best moves sequences
+    std::list <moves_sequence_t> moves_;
 
-    //! \brief table_size_ size of board table
-    coordinate_t table_size_;
+    //! \brief stats_ statistics of last search
+    SearchStats stats_;
 
-    //! \brief moves_ best moves sequences
-    std::list <std::list <Movement> > moves_;
+    //! \brief search_method_ how best moves are searched
+    SearchMethod search_method_;
+
+    //! \brief max_moves_ maximum length of moves sequence, 0 if unlimited
+    size_t max_moves_;
+
+    //! \brief visited_limit_ memory limit of visited states bitmap
+    size_t visited_limit_;
+
+    //! \brief moves_bound_ maximum length of moves sequence in current
+    //! search, 0 if unlimited
+    size_t moves_bound_;
+
+    //! \brief line_stops_ cell where last ball stopped in every row or
+    //! column during %RollAllBalls()
+    std::vector <coordinates_t> line_stops_;
+
+    //! \brief tilt_cache_ results of tilts done during search
+    TiltCache tilt_cache_;
+
+    //! \brief solution_cache_ persistent cache of solved games, can be nullptr
+    SolutionCache * solution_cache_;
+
+    //! \brief cancel_ flag raised to stop the search, can be nullptr
+    const std::atomic <bool> * cancel_;
+
+    //! \brief progress_ published search progress, can be nullptr
+    SearchProgress * progress_;
+
+    //! \brief expand_moves_ true if all the best sequences are listed
+    bool expand_moves_;
+
+    //! \brief solutions_ graph of the best moves sequences
+    SolutionGraph solutions_;
+
+    //! \brief solutions_ready_ true if %solutions_ describes %moves_
+    bool solutions_ready_;
+
+    //! \brief solutions_board_ board %moves_ were found on, kept by edits
+    //! until the graph is built. nullptr if game was not edited
+    std::shared_ptr <const Board> solutions_board_;
+
+    //! \brief solutions_balls_ balls %moves_ were found for, see
+    //! %solutions_board_
+    std::map <coordinates_t, Ball> solutions_balls_;
+
+    //!
+    //! \brief SetMoves replace best moves sequences with known ones
+    //! \param solutions best moves sequences
+    //!
+    void SetMoves (const std::list <moves_sequence_t> & solutions);
+
+    //!
+    //! \brief BuildSolutionGraph build graph of found moves by replaying
+    //! them, if search hasn't found it. Graph is left empty if any of the
+    //! sequences cannot be replayed
+    //!
+    void BuildSolutionGraph ();
+
+    //!
+    //! \brief KeepSolutionsGame remember the game found moves belong to
+    //! before it is edited, so the graph can be built later on request
+    //!
+    void KeepSolutionsGame ();
 
-    //! \brief holes_ initial holes positions
-    std::map <ball_id_t, coordinates_t> holes_;
+    //!
+    //! \brief EditBoard gives board which can be changed. Board shared with
+    //! other tables is copied first
+    //! \return board of this table only
+    //!
+    Board & EditBoard ();
 
     //!
-    //! \brief BuildMoveGraph build movement graph using initial board state
+    //! \brief BuildMoveGraph rebuild movement graph of the board from
+    //! scratch
     //!
     void BuildMoveGraph ();
 
     //!
-    //! \brief RollBall Roll ball from current position in specified direction
-    //! \param start_from start move position
-    //! \param to desired direction
-    //! \return cell where ball will stop and why
+    //! \brief The SearchNode struct Game state reached by some moves sequence.
+    //! Nodes live in search arena. Moves sequence is restored following
+    //! parent nodes
     //!
-    std::pair <Ball::CollisionResult, coordinates_t>
-    RollBall(const coordinates_t & start_from,
-             const Direction to) const;
+    struct SearchNode
+    {
+        //! \brief parent state before last move, nullptr for start state
+        const SearchNode * parent;
+
+        //! \brief depth number of moves done to reach the state
+        size_t depth;
+
+        //! \brief state balls and holes state
+        Movement state;
+    };
 
     //!
-    //! \brief FillGraphItemInDirection Fiil graph node in specified direction
-    //! \param gi graph node
-    //! \param current_cell cell graph node attached to
-    //! \param move_to direction
+    //! \brief The DeepeningSearch struct State of iterative deepening
+    //! search, see %DeepenGame()
     //!
-    void FillGraphItemInDirection (GraphItem & gi,
-                                   coordinates_t current_cell,
-                                   Direction move_to) const;
+    struct DeepeningSearch;
 
     //!
     //! \brief FindAllMoves find best sequince of moves to win the game
     //!
     void FindAllMoves ();
 
+    //!
+    //! \brief IsCancelled check if search must be stopped
+    //! \return true if cancellation flag is raised
+    //!
+    bool IsCancelled () const;
+
+    //!
+    //! \brief ReportProgress count expanded state in published progress
+    //! \param depth depth of the state
+    //!
+    void ReportProgress (size_t depth);
+
+    //!
+    //! \brief RacePortfolio run all the search methods in parallel on tables
+    //! sharing this table's board. The first method to finish gives the
+    //! moves, others are cancelled
+    //! \param rest cells where balls can stay
+    //!
+    void RacePortfolio (const RestCells & rest);
+
+    //!
+    //! \brief GetStartPoint gives initial state of the game
+    //! \return initial state
+    //!
+    Movement GetStartPoint () const;
+
+    //!
+    //! \brief CheckBalls look for frozen balls and balls separated from
+    //! their holes, number of frozen balls is counted in %stats_
+    //! \return reason why game cannot be won, %Unsolvability::None if the
+    //! balls may reach their holes
+    //!
+    Unsolvability CheckBalls ();
+
+    //!
+    //! \brief FindRestCells find cells where balls can stay
+    //! \return rest cells
+    //!
+    RestCells FindRestCells () const;
+
     //!
     //! \brief SimulateGame Simulate game untill best moves are found or no
     //! more possible moves. Makes BFS search in move graph simultaniously
-    //! for several nodes
-    //! \param moves
+    //! for several nodes. All search nodes are allocated in arena, which is
+    //! released when search is over
+    //! \param start_point initial state of the game
+    //! \param rest cells where balls can stay
+    //! \param order order of holes closing
+    //!
+    void SimulateGame (const Movement & start_point, const RestCells & rest,
+                       const HoleOrder & order);
+
     //!
-    void SimulateGame (std::list <std::list<Movement> > &moves);
+    //! \brief DeepenGame Simulate game by depth first searches limited by
+    //! growing depth, until best moves are found or no more possible moves.
+    //! Only current moves sequence is kept in arena, states reached before
+    //! are remembered in transposition table
+    //! \param start_point initial state of the game
+    //! \param rest cells where balls can stay
+    //! \param order order of holes closing
+    //!
+    void DeepenGame (const Movement & start_point, const RestCells & rest,
+                     const HoleOrder & order);
+
+    //!
+    //! \brief DeepenFrom search for wins in the subtree of the node, not
+    //! deeper than current depth limit
+    //! \param node current state
+    //! \param search search state
+    //! \return true if some win is found in the subtree
+    //!
+    bool DeepenFrom (SearchNode * node, DeepeningSearch & search);
+
+    //!
+    //! \brief RunBeam run one beam search. Search nodes of every depth are
+    //! allocated in their own arena, which is released when next depth is
+    //! selected
+    //! \param start_point initial state of the game
+    //! \param rest cells where balls can stay
+    //! \param order order of holes closing
+    //! \param width number of states kept at every depth
+    //! \param random random tie breaking, nullptr for deterministic search
+    //! \param deadline search is stopped at this time
+    //! \param best_length length of best moves found by all searches, 0 if
+    //! nothing is found yet. Longer sequences are not looked for
+    //! \return shortest moves sequence found, empty if none
+    //!
+    moves_sequence_t RunBeam (const Movement & start_point,
+                              const RestCells & rest,
+                              const HoleOrder & order, size_t width,
+                              Random * random,
+                              std::chrono::steady_clock::time_point deadline,
+                              const std::atomic <size_t> & best_length);
+
+    //!
+    //! \brief EstimateDistance estimate number of moves left to win from
+    //! the state
+    //! \param balls balls positions
+    //! \return sum of distances of all balls to their holes
+    //!
+    std::uint64_t EstimateDistance (const positions_t & balls) const;
+
+    //!
+    //! \brief NewSearchNode Create search node in current arena
+    //! \param parent previous state
+    //! \param state game state
+    //! \return new node
+    //!
+    SearchNode * NewSearchNode (const SearchNode * parent, Movement && state);
+
+    //!
+    //! \brief DeleteSearchNode Destroy search node and return its memory to
+    //! current arena
+    //! \param node node created by %NewSearchNode()
+    //!
+    static void DeleteSearchNode (SearchNode * node);
+
+    //!
+    //! \brief RankState gives rank of balls positions
+    //! \param ranker ranking of this game states
+    //! \param rest cells where balls can stay
+    //! \param balls balls positions
+    //! \param cells buffer for cells of all balls
+    //! \return state rank
+    //!
+    std::uint64_t RankState (const StateRanker & ranker,
+                             const RestCells & rest,
+                             const positions_t & balls,
+                             std::vector <std::uint32_t> & cells) const;
 
     //!
     //! \brief SaveMoves save move sequence pretending to be one of the best
-    //! \param moves moves sequence
+    //! \param node final state of moves sequence
     //! \return false if cannot add
     //!
-    bool SaveMoves (const std::list <Movement> & moves);
+    bool SaveMoves (const SearchNode * node);
+
+    //!
+    //! \brief ReplayMoves check if moves sequence wins the game. Search
+    //! statistics are not changed
+    //! \param start_point initial state of the game
+    //! \param moves moves sequence
+    //! \return number of moves done to win, 0 if sequence doesn't win
+    //!
+    size_t ReplayMoves (const Movement & start_point, const moves_sequence_t & moves);
+
+    //!
+    //! \brief IsDead check if some ball cannot reach its hole anymore
+    //! \param order order of holes closing
+    //! \param rest cells where balls can stay
+    //! \param balls balls positions
+    //! \return true if game cannot be won from this state
+    //!
+    static bool IsDead (const HoleOrder & order, const RestCells & rest,
+                        const positions_t & balls);
 
     //!
     //! \brief IsTooLotMoves check if current moves sequence is longer than
     //! known best ones. If so no need to process that sequence longer
-    //! \param moves moves sequence
+    //! \param moves_count moves sequence length
     //! \return true if too long, false in not
     //!
-    bool IsTooLotMoves (const std::list <Movement> & moves);
+    bool IsTooLotMoves (size_t moves_count);
 
     //!
     //! \brief RollAllBalls Roll all balls to specific direction and get balls
@@ -184,20 +630,28 @@ protected:
     //! roll gives valid game state
     //!
     bool RollAllBalls (Direction to,
-                       const std::map <coordinates_t, ball_id_t> & current_position,
-                       std::map<coordinates_t, ball_id_t> open_holes,
-                       std::map<coordinates_t, ball_id_t> &new_position,
-                       std::map<coordinates_t, ball_id_t> &new_position_removed);
+                       const positions_t & current_position,
+                       const positions_t & open_holes,
+                       positions_t & new_position,
+                       positions_t & new_position_removed);
+
+    //!
+    //! \brief RollAllBalls Roll all balls to direction known at compile
+    //! time. Called by run time version, see it for parameters
+    //!
+    template <Direction To>
+    bool RollAllBalls (const positions_t & current_position,
+                       const positions_t & open_holes,
+                       positions_t & new_position,
+                       positions_t & new_position_removed);
 
     //!
-    //! \brief MakeMove make one roll to the desired direction and form sequence
-    //! with that move included
-    //! \param moves current moves sequence
+    //! \brief MakeMove make one roll to the desired direction
+    //! \param node current state
     //! \param to direction of new move
-    //! \return sequence of moves with new move attached, empty list if move
-    //! cannot be done
+    //! \return new state in current arena, nullptr if move cannot be done
     //!
-    std::list <Movement> MakeMove (std::list<Movement> &moves, Direction to);
+    SearchNode * MakeMove (SearchNode * node, Direction to);
 };
 
 std::ostream &
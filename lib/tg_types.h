@@ -120,4 +120,7 @@ enum class Direction
     East   //!< move East
 };
 
+//! \brief Sequence of moves from initial state to the win
+using moves_sequence_t = std::vector<Direction>;
+
 #endif // TG_TYPES_H
@@ -52,13 +52,13 @@ operator!= (const coordinates_t & l, const coordinates_t & r)
 inline bool
 operator< (const coordinates_t & l, const coordinates_t & r)
 {
-    return (std::memcmp(&l, &r, sizeof(coordinates_t)) < 0);
+    return (l.x < r.x) || ((l.x == r.x) && (l.y < r.y));
 }
 
 inline bool
 operator<= (const coordinates_t & l, const coordinates_t & r)
 {
-    return (std::memcmp(&l, &r, sizeof(coordinates_t)) <= 0);
+    return !(r < l);
 }
 
 //!
@@ -188,7 +188,7 @@ GetNeighbourCell (const coordinates_t & cell, Direction side)
 template < typename T >
 inline bool HasDuplicates (const std::vector<T> & v)
 {
-    for(size_t i = 0; i < v.size() - 1; ++i)
+    for(size_t i = 0; i + 1 < v.size(); ++i)
     {
         for(size_t j = i+1; j < v.size(); ++j)
         {
@@ -233,7 +233,7 @@ inline std::ostream & operator<< (std::ostream & os, const Direction d)
 
 inline Direction ReverseDirection (Direction d)
 {
-    Direction reverse;
+    Direction reverse = d;
     switch (d)
     {
     case Direction::North:
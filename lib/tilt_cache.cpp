@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tilt_cache.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+//!
+//! \brief Pack pack object position and id to single word
+//! \param object position and id
+//! \return packed object
+//!
+std::uint64_t Pack (const std::pair <const coordinates_t, ball_id_t> & object)
+{
+    return (static_cast<std::uint64_t>(object.first.x) << 40) ^
+           (static_cast<std::uint64_t>(object.first.y) << 20) ^
+           object.second;
+}
+
+//!
+//! \brief Mix add word to the hash
+//! \param hash current hash value
+//! \param word new word
+//! \return new hash value
+//!
+std::uint64_t Mix (std::uint64_t hash, std::uint64_t word)
+{
+    hash ^= word + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash * 0xFF51AFD7ED558CCDULL;
+}
+
+//!
+//! \brief Restore copy stored positions to the search container
+//! \param from stored positions
+//! \param to search container
+//!
+void Restore (const std::vector <std::pair <coordinates_t, ball_id_t> > & from,
+              positions_t & to)
+{
+    to.clear();
+    for (auto & object : from)
+    {
+        to.emplace_hint(to.end(), object.first, object.second);
+    }
+}
+
+//!
+//! \brief Save copy positions from the search container
+//! \param from search container
+//! \param to stored positions
+//!
+void Save (const positions_t & from,
+           std::vector <std::pair <coordinates_t, ball_id_t> > & to)
+{
+    to.assign(from.begin(), from.end());
+}
+
+} // namespace
+
+const size_t TiltCache::kDefaultSize;
+
+TiltCache::TiltCache(size_t size)
+    : slots_count_(0)
+    , hash_(0)
+    , slot_(nullptr)
+    , to_(Direction::North)
+    , hits_(0)
+    , misses_(0)
+{
+    Resize(size);
+}
+
+void TiltCache::Resize(size_t size)
+{
+    size_t slots = 1;
+    while ((slots << 1) <= size)
+    {
+        slots <<= 1;
+    }
+
+    slots_.clear();
+    slots_.shrink_to_fit();
+    slots_count_ = (size != 0) ? slots : 0;
+    Clear();
+}
+
+void TiltCache::Clear()
+{
+    for (auto & slot : slots_)
+    {
+        slot.used = false;
+    }
+    slot_ = nullptr;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+bool TiltCache::Lookup(Direction to, const positions_t &balls,
+                       const positions_t &holes, positions_t &new_position,
+                       positions_t &removed_balls, bool &game_ok)
+{
+    slot_ = nullptr;
+    if (slots_.size() != slots_count_)
+    {
+        slots_.resize(slots_count_);
+    }
+    if (slots_.empty())
+    {
+        return false;
+    }
+
+    key_.clear();
+    hash_ = static_cast<std::uint64_t>(to);
+    for (auto & ball : balls)
+    {
+        key_.push_back(Pack(ball));
+        hash_ = Mix(hash_, key_.back());
+    }
+    // balls and holes lists are separated by invalid object
+    key_.push_back(0);
+    for (auto & hole : holes)
+    {
+        key_.push_back(Pack(hole));
+        hash_ = Mix(hash_, key_.back());
+    }
+    to_ = to;
+
+    Slot & slot = slots_[(hash_ ^ (hash_ >> 32)) & (slots_.size() - 1)];
+    if (slot.used && (slot.hash == hash_) && (slot.to == to) && (slot.key == key_))
+    {
+        ++hits_;
+        Restore(slot.new_position, new_position);
+        Restore(slot.removed_balls, removed_balls);
+        game_ok = slot.game_ok;
+        return true;
+    }
+
+    ++misses_;
+    slot_ = &slot;
+    return false;
+}
+
+void TiltCache::Store(const positions_t &new_position,
+                      const positions_t &removed_balls, bool game_ok)
+{
+    if (slot_ == nullptr)
+    {
+        return;
+    }
+
+    slot_->used = true;
+    slot_->game_ok = game_ok;
+    slot_->to = to_;
+    slot_->hash = hash_;
+    slot_->key.swap(key_);
+    Save(new_position, slot_->new_position);
+    Save(removed_balls, slot_->removed_balls);
+    slot_ = nullptr;
+}
+
+size_t TiltCache::GetHits() const
+{
+    return hits_;
+}
+
+size_t TiltCache::GetMisses() const
+{
+    return misses_;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016, Ivan Koveshnikov
+ * ikoveshnik@gmail.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_TILT_CACHE_H
+#define TG_TILT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "movement.h"
+#include "tg_types.h"
+
+//!
+//! \brief The TiltCache class Bounded cache of tilt results.
+//!
+//! The same balls and holes state is reached by many moves sequences, so
+//! the same tilt is computed again and again. Cache is direct-mapped: every
+//! state and direction has single slot, new result replaces the old one.
+//! Slot keeps full packed state, so hash collisions never give wrong result.
+//!
+class TiltCache
+{
+public:
+    //! \brief kDefaultSize default number of cache slots
+    static const size_t kDefaultSize = 1 << 16;
+
+    //!
+    //! \brief TiltCache Create cache. Slots are allocated by first lookup,
+    //! so tables which never search don't pay for them
+    //! \param size number of slots, rounded down to power of two. Zero
+    //! disables the cache
+    //!
+    explicit TiltCache (size_t size = kDefaultSize);
+
+    //!
+    //! \brief Resize change number of slots and drop all results
+    //! \param size number of slots, zero disables the cache
+    //!
+    void Resize (size_t size);
+
+    //!
+    //! \brief Clear drop all results and reset counters
+    //!
+    void Clear ();
+
+    //!
+    //! \brief Lookup find result of the tilt
+    //! \param to tilt direction
+    //! \param balls balls positions before the tilt
+    //! \param holes open holes
+    //! \param new_position balls positions after the tilt
+    //! \param removed_balls balls which fell to their holes
+    //! \param game_ok false if some ball falls to other's hole
+    //! \return true if result is found
+    //!
+    bool Lookup (Direction to, const positions_t & balls,
+                 const positions_t & holes, positions_t & new_position,
+                 positions_t & removed_balls, bool & game_ok);
+
+    //!
+    //! \brief Store save result of the tilt for the state of last missed
+    //! %Lookup() call
+    //! \param new_position balls positions after the tilt
+    //! \param removed_balls balls which fell to their holes
+    //! \param game_ok false if some ball falls to other's hole
+    //!
+    void Store (const positions_t & new_position,
+                const positions_t & removed_balls, bool game_ok);
+
+    //!
+    //! \brief GetHits number of found results since last %Clear()
+    //! \return hits count
+    //!
+    size_t GetHits () const;
+
+    //!
+    //! \brief GetMisses number of missed results since last %Clear()
+    //! \return misses count
+    //!
+    size_t GetMisses () const;
+
+private:
+    //! \brief objects_t positions stored out of search arena
+    using objects_t = std::vector <std::pair <coordinates_t, ball_id_t> >;
+
+    //!
+    //! \brief The Slot struct Cached tilt result
+    //!
+    struct Slot
+    {
+        bool used;                          //!< slot has result
+        bool game_ok;                       //!< result of the tilt
+        Direction to;                       //!< tilt direction
+        std::uint64_t hash;                 //!< hash of %key
+        std::vector <std::uint64_t> key;    //!< packed state before the tilt
+        objects_t new_position;             //!< balls after the tilt
+        objects_t removed_balls;            //!< balls in holes after the tilt
+    };
+
+    //! \brief slots_ cache slots, empty until first lookup
+    std::vector <Slot> slots_;
+
+    //! \brief slots_count_ number of slots to be allocated
+    size_t slots_count_;
+
+    //! \brief key_ packed state of last lookup
+    std::vector <std::uint64_t> key_;
+
+    //! \brief hash_ hash of last lookup key
+    std::uint64_t hash_;
+
+    //! \brief slot_ slot of last missed lookup, nullptr if nothing to store
+    Slot * slot_;
+
+    //! \brief to_ direction of last lookup
+    Direction to_;
+
+    //! \brief hits_ found results counter
+    size_t hits_;
+
+    //! \brief misses_ missed results counter
+    size_t misses_;
+};
+
+#endif // TG_TILT_CACHE_H
@@ -30,14 +30,19 @@
  */
 
 #include <cstddef>
+#include <cstdlib>
 #include <string>
 #include <iostream>
+#include <memory>
 #include <getopt.h>
+#include <unistd.h>
 
 #include "tg_types.h"
 #include "file_ops.h"
 #include "input.h"
 #include "table.h"
+#include "solution_cache.h"
+#include "moves_writer.h"
 
 void Usage (std::string program_name)
 {
@@ -54,6 +59,24 @@ void Usage (std::string program_name)
            "  -f, --file        File name containing input data\n"
            "  -h, --help        Display this help and exit\n"
            "  -d, --debug       Show debug output\n"
+           "  -c, --cache       File name of persistent solutions cache\n"
+           "  -s, --stats       Print search statistics to stderr\n"
+           "  -m, --max-moves   Don't look for moves sequences longer than this\n"
+           "  -k, --check       Only check if game is known to be unsolvable,\n"
+           "                    print the reason or 'none' without search\n"
+           "  -b, --beam        Approximate search keeping this number of states\n"
+           "                    at every depth. Single moves sequence is printed,\n"
+           "                    it may be not the shortest one\n"
+           "  -r, --rollouts    Number of approximate searches, default is 8\n"
+           "  -t, --time-limit  Time limit of approximate search, milliseconds\n"
+           "  -j, --jobs        Number of threads of approximate search,\n"
+           "                    default is number of CPUs\n"
+           "  -p, --portfolio   Run all exact search methods in parallel,\n"
+           "                    the first one to finish gives the moves\n"
+           "  -g, --graph       Print graph of states of the best moves\n"
+           "                    sequences instead of listing all of them\n"
+           "  -w, --write       Write moves by buffered write(2) instead of\n"
+           "                    streams, output is the same\n"
               << std::endl;
 }
 
@@ -65,17 +88,37 @@ int main(int argc, char *argv[])
         {"file",    required_argument, NULL, 'f'},
         {"help",    no_argument,       NULL, 'h'},
         {"debug",   no_argument,       NULL, 'd'},
+        {"cache",   required_argument, NULL, 'c'},
+        {"stats",   no_argument,       NULL, 's'},
+        {"max-moves", required_argument, NULL, 'm'},
+        {"check",   no_argument,       NULL, 'k'},
+        {"beam",    required_argument, NULL, 'b'},
+        {"rollouts", required_argument, NULL, 'r'},
+        {"time-limit", required_argument, NULL, 't'},
+        {"jobs",    required_argument, NULL, 'j'},
+        {"portfolio", no_argument,     NULL, 'p'},
+        {"graph",   no_argument,       NULL, 'g'},
+        {"write",   no_argument,       NULL, 'w'},
         {NULL, 0, NULL, 0}
     };
 
     bool parse_error = false;
     bool enable_debug = false;
+    bool enable_stats = false;
+    bool check_only = false;
+    bool portfolio = false;
+    bool print_graph = false;
+    bool buffered_write = false;
+    size_t max_moves = 0;
+    BeamOptions beam;
+    beam.width = 0;
     std::string filename;
+    std::string cache_filename;
 
     while (1)
     {
         int long_index = 0;
-        int opt = getopt_long(argc, argv, "f:h:d", longopts, &long_index);
+        int opt = getopt_long(argc, argv, "f:h:dc:sm:kb:r:t:j:pgw", longopts, &long_index);
 
         if (opt == -1)
             break;	/* No more options */
@@ -89,6 +132,50 @@ int main(int argc, char *argv[])
             enable_debug = true;
             break;
 
+        case 'c':
+            cache_filename = optarg;
+            break;
+
+        case 's':
+            enable_stats = true;
+            break;
+
+        case 'm':
+            max_moves = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case 'k':
+            check_only = true;
+            break;
+
+        case 'b':
+            beam.width = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case 'r':
+            beam.rollouts = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case 't':
+            beam.time_limit_ms = std::strtoull(optarg, NULL, 10);
+            break;
+
+        case 'j':
+            beam.threads = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case 'p':
+            portfolio = true;
+            break;
+
+        case 'g':
+            print_graph = true;
+            break;
+
+        case 'w':
+            buffered_write = true;
+            break;
+
         case 'h':
         default:
             parse_error = true;
@@ -114,14 +201,86 @@ int main(int argc, char *argv[])
     }
 
     GameTable t(data);
-    t.CalculateMoves();
+    t.SetMaxMoves(max_moves);
+    if (portfolio)
+    {
+        t.SetSearchMethod(SearchMethod::Portfolio);
+    }
+    t.SetExpandMoves(!print_graph);
+
+    if (check_only)
+    {
+        std::cout << t.CheckSolvability() << std::endl;
+        if (enable_stats)
+        {
+            std::cerr << t.GetStats() << std::endl;
+        }
+        return 0;
+    }
+
+    std::unique_ptr <SolutionCache> cache;
+    if (!cache_filename.empty() && (beam.width == 0))
+    {
+        cache.reset(new SolutionCache(cache_filename));
+        if (!cache->IsOpen())
+        {
+            std::cout << "Cannot open solutions cache " << cache_filename;
+            return 1;
+        }
+        t.SetSolutionCache(cache.get());
+    }
+
+    if (beam.width != 0)
+    {
+        t.CalculateApproximateMoves(beam);
+    }
+    else
+    {
+        t.CalculateMoves();
+    }
 
     if (enable_debug)
     {
         std::cout << t;
+        std::cout << "Search memory peak: " << t.GetSearchMemoryPeak()
+                  << " bytes\n\n";
+
+        if (cache)
+        {
+            std::cout << "Cache: hits " << cache->GetHits()
+                      << ", misses " << cache->GetMisses()
+                      << ", records " << cache->GetRecordsCount()
+                      << ", evicted " << cache->GetEvictions() << "\n\n";
+        }
     }
 
-    t.PrintMoves(std::cout);
+    if (!t.IsOptimal())
+    {
+        std::cout << "# approximate search, moves may be not the shortest\n";
+    }
+    if (print_graph)
+    {
+        t.GetSolutionGraph().Print(std::cout);
+    }
+    else if (buffered_write)
+    {
+        // writer doesn't know about text buffered by the stream
+        std::cout.flush();
+        MovesWriter writer (STDOUT_FILENO);
+        if (!t.WriteMoves(writer) || !writer.Flush())
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        t.PrintMoves(std::cout);
+    }
+
+    if (enable_stats)
+    {
+        std::cerr << t.GetStats() << std::endl;
+    }
 
     return 0;
 }
@@ -0,0 +1,212 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_analysis"
+
+#include <boost/test/unit_test.hpp>
+
+#include <list>
+#include <vector>
+
+#include "analysis.h"
+#include "table.h"
+#include "tg_utils.h"
+
+class AnalysisTable : public GameTable
+{
+public:
+    AnalysisTable(const input_data_t & data) : GameTable(InputData(data)) {}
+
+    std::vector <ball_id_t> GetFrozenBalls () const
+    {
+        return FindFrozenBalls(board_->GetMoveGraph(), balls_);
+    }
+
+    RestCells GetRestCells () const
+    {
+        std::vector <coordinates_t> starts;
+        for (auto & ball : balls_)
+        {
+            starts.push_back(ball.first);
+        }
+        return RestCells(board_->GetTableSize(), board_->GetMoveGraph(), starts);
+    }
+
+    HoleOrder GetHoleOrder () const
+    {
+        return HoleOrder(GetRestCells(), board_->GetMoveGraph(), balls_,
+                         board_->GetHoles());
+    }
+};
+
+BOOST_AUTO_TEST_CASE( walled_ball )
+{
+    // ball is surrounded by walls from all the sides
+    input_data_t data {3, 1, 4,
+                       2, 2,
+                       1, 1,
+                       2, 2, 2, 1,
+                       2, 2, 1, 2,
+                       2, 2, 3, 2,
+                       2, 2, 2, 3};
+    AnalysisTable t (data);
+    BOOST_CHECK(t.GetFrozenBalls() == std::vector<ball_id_t>({1}));
+
+    GameTable game ((InputData(data)));
+    game.CalculateMoves();
+    BOOST_CHECK(game.GetMoves().empty());
+    BOOST_CHECK_EQUAL(game.GetStats().frozen_balls, 1);
+    BOOST_CHECK_EQUAL(game.GetStats().GetExpanded(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( blocking_balls )
+{
+    // balls in the corner block each other, nothing else holds them
+    AnalysisTable t ({3, 2, 3,
+                      1, 3, 2, 3,
+                      1, 1, 3, 1,
+                      1, 3, 1, 2,
+                      2, 3, 2, 2,
+                      2, 3, 3, 3});
+    BOOST_CHECK(t.GetFrozenBalls() == std::vector<ball_id_t>({1, 2}));
+
+    // second ball can go east, then the first one is free too
+    AnalysisTable free ({3, 2, 2,
+                         1, 3, 2, 3,
+                         1, 1, 3, 1,
+                         1, 3, 1, 2,
+                         2, 3, 2, 2});
+    BOOST_CHECK(free.GetFrozenBalls().empty());
+}
+
+BOOST_AUTO_TEST_CASE( no_frozen_balls )
+{
+    GameTable game (InputData({4, 2, 1,
+                               1, 1, 2, 3,
+                               4, 1, 4, 4,
+                               2, 1, 3, 1}));
+    game.CalculateMoves();
+    BOOST_CHECK_EQUAL(game.GetStats().frozen_balls, 0);
+}
+
+BOOST_AUTO_TEST_CASE( hole_dependency )
+{
+    // first ball rolls over the second hole to get out of the corner
+    input_data_t data {4, 2, 2,
+                       1, 1, 2, 4,
+                       3, 3, 2, 1,
+                       1, 1, 1, 2,
+                       3, 1, 4, 1};
+    AnalysisTable t (data);
+    HoleOrder order = t.GetHoleOrder();
+    BOOST_CHECK(!order.IsCyclic());
+    BOOST_CHECK(order.IsSolvable());
+    BOOST_CHECK_EQUAL(order.GetDependenciesCount(), 1);
+    BOOST_CHECK(order.MustDropBefore(2, 1));
+    BOOST_CHECK(!order.MustDropBefore(1, 2));
+
+    GameTable game ((InputData(data)));
+    game.CalculateMoves();
+    std::list <moves_sequence_t> expected {{Direction::North, Direction::East,
+                                            Direction::South}};
+    BOOST_CHECK(game.GetMoves() == expected);
+    BOOST_CHECK_EQUAL(game.GetStats().hole_dependencies, 1);
+}
+
+BOOST_AUTO_TEST_CASE( cyclic_dependency )
+{
+    // every ball has to roll over other's hole
+    input_data_t data {3, 2, 4,
+                       2, 1, 3, 3,
+                       2, 3, 1, 2,
+                       3, 1, 3, 2,
+                       1, 2, 2, 2,
+                       2, 2, 3, 2,
+                       2, 2, 2, 3};
+    AnalysisTable t (data);
+    HoleOrder order = t.GetHoleOrder();
+    BOOST_CHECK(order.IsCyclic());
+    BOOST_CHECK(!order.IsSolvable());
+    BOOST_CHECK(order.MustDropBefore(1, 2));
+    BOOST_CHECK(order.MustDropBefore(2, 1));
+
+    GameTable game ((InputData(data)));
+    game.CalculateMoves();
+    BOOST_CHECK(game.GetMoves().empty());
+    BOOST_CHECK_EQUAL(game.GetStats().GetExpanded(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( dead_cells )
+{
+    // first ball must drop before the second one, so the second hole is
+    // open all the way of the first ball and it cannot leave the corner
+    // behind this hole
+    AnalysisTable t ({3, 2, 4,
+                      3, 3, 3, 1,
+                      3, 2, 2, 1,
+                      1, 1, 1, 2,
+                      2, 1, 3, 1,
+                      1, 2, 1, 3,
+                      1, 3, 2, 3});
+    RestCells rest = t.GetRestCells();
+    HoleOrder order = t.GetHoleOrder();
+    BOOST_CHECK(order.IsSolvable());
+    BOOST_CHECK(order.MustDropBefore(1, 2));
+    for (std::uint32_t cell = 0; cell < rest.GetCount(); ++cell)
+    {
+        BOOST_CHECK_EQUAL(order.IsDead(1, cell),
+                          rest.GetCell(cell) == coordinates_t(1, 1));
+        BOOST_CHECK(!order.IsDead(2, cell));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( separated_hole )
+{
+    // ball rolls along the first column, but hole is outside of it
+    GameTable game (InputData({3, 1, 3,
+                               1, 1,
+                               3, 3,
+                               1, 1, 2, 1,
+                               1, 2, 2, 2,
+                               1, 3, 2, 3}));
+    BOOST_CHECK_EQUAL(game.CheckSolvability(), Unsolvability::SeparatedHole);
+    BOOST_CHECK_EQUAL(game.GetStats().frozen_balls, 0);
+
+    game.CalculateMoves();
+    BOOST_CHECK(game.GetMoves().empty());
+    BOOST_CHECK_EQUAL(game.GetStats().unsolvability, Unsolvability::SeparatedHole);
+    BOOST_CHECK_EQUAL(game.GetStats().GetExpanded(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( unsolvability_reasons )
+{
+    // single ball stays only in the corners and never crosses the center
+    GameTable unreachable (InputData({3, 1, 0,
+                                      1, 1,
+                                      2, 2}));
+    BOOST_CHECK_EQUAL(unreachable.CheckSolvability(), Unsolvability::UnreachableHole);
+
+    GameTable frozen (InputData({3, 1, 4,
+                                 2, 2,
+                                 1, 1,
+                                 2, 2, 2, 1,
+                                 2, 2, 1, 2,
+                                 2, 2, 3, 2,
+                                 2, 2, 2, 3}));
+    BOOST_CHECK_EQUAL(frozen.CheckSolvability(), Unsolvability::FrozenBall);
+
+    GameTable cyclic (InputData({3, 2, 4,
+                                 2, 1, 3, 3,
+                                 2, 3, 1, 2,
+                                 3, 1, 3, 2,
+                                 1, 2, 2, 2,
+                                 2, 2, 3, 2,
+                                 2, 2, 2, 3}));
+    BOOST_CHECK_EQUAL(cyclic.CheckSolvability(), Unsolvability::CyclicOrder);
+
+    GameTable solvable (InputData({4, 2, 1,
+                                   1, 1, 2, 3,
+                                   4, 1, 4, 4,
+                                   2, 1, 3, 1}));
+    BOOST_CHECK_EQUAL(solvable.CheckSolvability(), Unsolvability::None);
+    solvable.CalculateMoves();
+    BOOST_CHECK(!solvable.GetMoves().empty());
+}
@@ -0,0 +1,98 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_arena"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <vector>
+
+#include "arena.h"
+#include "table.h"
+#include "tests_config.h"
+
+BOOST_AUTO_TEST_CASE( reuse_chunks )
+{
+    Arena arena (4096);
+
+    void * first = arena.Allocate(40);
+    void * second = arena.Allocate(48);
+    BOOST_CHECK(first != second);
+    BOOST_CHECK_EQUAL(arena.GetBytesInUse(), 96);
+
+    arena.Deallocate(first, 40);
+    BOOST_CHECK_EQUAL(arena.GetBytesInUse(), 48);
+
+    // chunks of the same size class are reused
+    BOOST_CHECK(arena.Allocate(33) == first);
+    BOOST_CHECK_EQUAL(arena.GetBytesReserved(), 4096);
+    BOOST_CHECK_EQUAL(arena.GetPeakBytesInUse(), 96);
+
+    // big chunks get their own blocks
+    arena.Allocate(10000);
+    BOOST_CHECK_EQUAL(arena.GetBytesReserved(), 4096 + 10000);
+
+    arena.Release();
+    BOOST_CHECK_EQUAL(arena.GetBytesReserved(), 0);
+    BOOST_CHECK_EQUAL(arena.GetBytesInUse(), 0);
+    BOOST_CHECK(arena.GetPeakBytesReserved() > 4096);
+}
+
+BOOST_AUTO_TEST_CASE( scope )
+{
+    BOOST_CHECK(Arena::GetCurrent() == nullptr);
+
+    Arena outer;
+    Arena inner;
+    {
+        ArenaScope outer_scope (outer);
+        BOOST_CHECK(Arena::GetCurrent() == &outer);
+        {
+            ArenaScope inner_scope (inner);
+            BOOST_CHECK(Arena::GetCurrent() == &inner);
+        }
+        BOOST_CHECK(Arena::GetCurrent() == &outer);
+    }
+    BOOST_CHECK(Arena::GetCurrent() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE( containers )
+{
+    using map_t = std::map <int, int, std::less <int>,
+                            ArenaAllocator <std::pair <const int, int> > >;
+
+    Arena arena;
+    map_t copy;
+    {
+        ArenaScope scope (arena);
+
+        map_t in_arena;
+        for (int i = 0; i < 100; ++i)
+        {
+            in_arena[i] = i * i;
+        }
+        BOOST_CHECK(in_arena.get_allocator().GetArena() == &arena);
+        BOOST_CHECK(arena.GetBytesInUse() > 0);
+
+        std::vector <int, ArenaAllocator <int> > v (100, 1);
+        BOOST_CHECK(v.get_allocator().GetArena() == &arena);
+
+        copy.insert(in_arena.begin(), in_arena.end());
+    }
+
+    // copy made outside of the arena doesn't depend on it
+    map_t out_of_arena (copy);
+    BOOST_CHECK(out_of_arena.get_allocator().GetArena() == nullptr);
+    arena.Release();
+    BOOST_CHECK_EQUAL(out_of_arena.size(), 100);
+    BOOST_CHECK_EQUAL(out_of_arena.at(10), 100);
+}
+
+BOOST_AUTO_TEST_CASE( search_memory )
+{
+    GameTable t (sample);
+    BOOST_CHECK_EQUAL(t.GetSearchMemoryPeak(), 0);
+
+    t.CalculateMoves();
+    BOOST_CHECK(t.GetSearchMemoryPeak() > 0);
+    BOOST_CHECK(Arena::GetCurrent() == nullptr);
+}
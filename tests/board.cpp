@@ -0,0 +1,103 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_board"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "board.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+BOOST_AUTO_TEST_CASE( distances )
+{
+    // single hole in the middle of the board
+    Board board (InputData({3,1,1, 1,1, 2,2, 1,2,1,3}));
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(2,2)), 0);
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(1,2)), 1);
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(2,3)), 1);
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(1,1)), 2);
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(3,3)), 4);
+    BOOST_CHECK_EQUAL(board.GetDistance(2, coordinates_t(1,1)), Board::kUnreachable);
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(4,1)), Board::kUnreachable);
+
+    // without the wall ball in the corner never stops in the middle lines
+    BOOST_CHECK(board.SetWall(wall_coordinates_t(1,2, 1,3), false));
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(1,1)), Board::kUnreachable);
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(3,3)), Board::kUnreachable);
+    BOOST_CHECK(board.MoveHole(1, coordinates_t(1,2)));
+    BOOST_CHECK_EQUAL(board.GetDistance(1, coordinates_t(1,1)), 1);
+}
+
+BOOST_AUTO_TEST_CASE( shared_board )
+{
+    GameTable original (sample);
+    original.CalculateMoves();
+
+    std::shared_ptr <const Board> board = original.GetSharedBoard();
+    GameTable same (board, {coordinates_t(SAMPLE_BALL_1),
+                            coordinates_t(SAMPLE_BALL_2)});
+    BOOST_CHECK(same.GetSharedBoard() == board);
+    BOOST_CHECK(same.GetPuzzleKey() == original.GetPuzzleKey());
+    same.CalculateMoves();
+    BOOST_CHECK(same.GetMoves() == original.GetMoves());
+
+    // edited table gets its own copy of the board
+    input_data_t key = same.GetPuzzleKey();
+    BOOST_CHECK(same.AddWall(wall_coordinates_t(1,1, 2,1)));
+    BOOST_CHECK(same.GetSharedBoard() != board);
+    BOOST_CHECK(same.GetPuzzleKey() != key);
+    BOOST_CHECK(original.GetPuzzleKey() == key);
+    BOOST_CHECK(original.GetSharedBoard() == board);
+}
+
+BOOST_AUTO_TEST_CASE( concurrent_solves )
+{
+    GameTable original (sample);
+    std::shared_ptr <const Board> board = original.GetSharedBoard();
+
+    // all placements of the balls on free cells
+    std::vector <std::vector <coordinates_t>> starts;
+    for (auto & first : board->GetCells())
+    {
+        for (auto & second : board->GetCells())
+        {
+            if (!first.second.HasHole() && !second.second.HasHole() &&
+                (first.first != second.first))
+            {
+                starts.push_back({first.first, second.first});
+            }
+        }
+    }
+
+    std::vector <std::list <moves_sequence_t>> moves (starts.size());
+    std::vector <std::thread> threads;
+    const size_t threads_count = 4;
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&, t] ()
+        {
+            for (size_t i = t; i < starts.size(); i += threads_count)
+            {
+                GameTable table (board, starts[i]);
+                table.CalculateMoves();
+                moves[i] = table.GetMoves();
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        GameTable shared (board, starts[i]);
+        GameTable fresh ((InputData(shared.GetPuzzleKey())));
+        fresh.CalculateMoves();
+        BOOST_CHECK_MESSAGE(moves[i] == fresh.GetMoves(), "placement " << i);
+    }
+}
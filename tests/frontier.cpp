@@ -0,0 +1,114 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_frontier"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "frontier.h"
+#include "generator.h"
+
+namespace
+{
+
+std::vector <CompressedFrontier::state_t>
+ReadAll (const CompressedFrontier & frontier)
+{
+    std::vector <CompressedFrontier::state_t> states;
+    CompressedFrontier::Reader reader (frontier);
+    CompressedFrontier::state_t state;
+    while (reader.Next(state))
+    {
+        states.push_back(state);
+    }
+    return states;
+}
+
+std::vector <CompressedFrontier::state_t>
+RandomStates (std::uint64_t seed, size_t count, std::uint32_t bound)
+{
+    Random random (seed);
+    std::vector <CompressedFrontier::state_t> states;
+    for (size_t i = 0; i < count; ++i)
+    {
+        states.push_back(random.Next(bound) |
+                         (static_cast<CompressedFrontier::state_t>(random.Next(2)) << 60));
+    }
+    return states;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( frontier_assign )
+{
+    auto states = RandomStates(1, 1000, 5000);
+    auto expected = states;
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    CompressedFrontier frontier;
+    frontier.Assign(states);
+    BOOST_CHECK_EQUAL(frontier.GetSize(), expected.size());
+    BOOST_CHECK(ReadAll(frontier) == expected);
+
+    // close states take much less than 8 bytes
+    BOOST_CHECK(frontier.GetBytes() < expected.size() * 3);
+
+    for (CompressedFrontier::state_t state = 0; state < 5000; ++state)
+    {
+        BOOST_CHECK_EQUAL(frontier.Contains(state),
+                          std::binary_search(expected.begin(), expected.end(), state));
+    }
+    BOOST_CHECK(frontier.Contains(expected.back()));
+    BOOST_CHECK(!frontier.Contains(expected.back() + 1));
+
+    frontier.Clear();
+    BOOST_CHECK_EQUAL(frontier.GetSize(), 0);
+    BOOST_CHECK(ReadAll(frontier).empty());
+    BOOST_CHECK(!frontier.Contains(0));
+}
+
+BOOST_AUTO_TEST_CASE( frontier_merge )
+{
+    auto a = RandomStates(2, 700, 3000);
+    auto b = RandomStates(3, 900, 3000);
+    auto expected = a;
+    expected.insert(expected.end(), b.begin(), b.end());
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    CompressedFrontier fa;
+    CompressedFrontier fb;
+    fa.Assign(a);
+    fb.Assign(b);
+
+    BOOST_CHECK(ReadAll(CompressedFrontier::Merge(fa, fb)) == expected);
+    BOOST_CHECK(ReadAll(CompressedFrontier::Merge(fa, CompressedFrontier())) == ReadAll(fa));
+}
+
+BOOST_AUTO_TEST_CASE( frontier_difference )
+{
+    auto a = RandomStates(4, 2000, 4000);
+    std::vector <CompressedFrontier> excluded (2);
+    auto b = RandomStates(5, 500, 4000);
+    auto c = RandomStates(6, 500, 4000);
+    excluded[0].Assign(b);
+    excluded[1].Assign(c);
+
+    CompressedFrontier fa;
+    fa.Assign(a);
+
+    std::vector <CompressedFrontier::state_t> expected;
+    for (auto state : a)
+    {
+        if (!std::binary_search(b.begin(), b.end(), state) &&
+            !std::binary_search(c.begin(), c.end(), state) &&
+            (expected.empty() || (expected.back() != state)))
+        {
+            expected.push_back(state);
+        }
+    }
+
+    BOOST_CHECK(ReadAll(CompressedFrontier::Difference(fa, excluded)) == expected);
+}
@@ -0,0 +1,100 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_generator"
+
+#include <boost/test/unit_test.hpp>
+
+#include "generator.h"
+#include "input.h"
+#include "table.h"
+#include "tg_utils.h"
+
+BOOST_AUTO_TEST_CASE( valid_puzzles )
+{
+    GeneratorOptions options;
+    options.table_size = 6;
+    options.balls_count = 3;
+    options.wall_percent = 30;
+
+    for (std::uint64_t i = 0; i < 100; ++i)
+    {
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(options, i, puzzle));
+
+        InputData data (puzzle);
+        BOOST_CHECK_EQUAL(data.GetDataStatus(), InputData::Status::Ok);
+        BOOST_CHECK_EQUAL(data.GetTableSize(), 6u);
+        BOOST_CHECK_EQUAL(data.GetBallCount(), 3u);
+    }
+
+    options.balls_count = 19;
+    BOOST_CHECK(!IsValid(options));
+}
+
+BOOST_AUTO_TEST_CASE( deterministic )
+{
+    GeneratorOptions options;
+    options.seed = 42;
+
+    input_data_t first;
+    input_data_t second;
+    BOOST_REQUIRE(GeneratePuzzle(options, 7, first));
+    BOOST_REQUIRE(GeneratePuzzle(options, 7, second));
+    BOOST_CHECK(first == second);
+
+    BOOST_REQUIRE(GeneratePuzzle(options, 8, second));
+    BOOST_CHECK(first != second);
+
+    options.seed = 43;
+    BOOST_REQUIRE(GeneratePuzzle(options, 7, second));
+    BOOST_CHECK(first != second);
+}
+
+BOOST_AUTO_TEST_CASE( moves_filter )
+{
+    GeneratorOptions options;
+    options.table_size = 5;
+    options.min_moves = 4;
+    options.max_moves = 5;
+
+    for (std::uint64_t i = 0; i < 10; ++i)
+    {
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(options, i, puzzle));
+
+        GameTable table (InputData{puzzle});
+        table.CalculateMoves();
+        std::list <moves_sequence_t> moves = table.GetMoves();
+        BOOST_REQUIRE(!moves.empty());
+        BOOST_CHECK_GE(moves.front().size(), 4u);
+        BOOST_CHECK_LE(moves.front().size(), 5u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( parallel_order )
+{
+    GeneratorOptions options;
+    options.table_size = 8;
+    options.max_moves = 4;
+
+    std::vector <std::uint64_t> indexes;
+    std::vector <input_data_t> puzzles;
+    size_t generated = GeneratePuzzles(options, 50, 4,
+        [&] (std::uint64_t index, const input_data_t & puzzle)
+        {
+            indexes.push_back(index);
+            puzzles.push_back(puzzle);
+        });
+
+    BOOST_CHECK_EQUAL(generated, puzzles.size());
+    for (size_t i = 0; i < puzzles.size(); ++i)
+    {
+        if (i > 0)
+        {
+            BOOST_CHECK_LT(indexes[i - 1], indexes[i]);
+        }
+
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(options, indexes[i], puzzle));
+        BOOST_CHECK(puzzle == puzzles[i]);
+    }
+}
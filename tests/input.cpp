@@ -113,3 +113,11 @@ BOOST_AUTO_TEST_CASE (no_balls)
 
     BOOST_CHECK_EQUAL(data.GetDataStatus(), InputData::Status::NoBalls);
 }
+
+BOOST_AUTO_TEST_CASE (no_walls)
+{
+    InputData data (sample_no_walls);
+
+    BOOST_CHECK_EQUAL(data.GetDataStatus(), InputData::Status::Ok);
+    BOOST_CHECK(data.GetWalls().empty());
+}
@@ -0,0 +1,106 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_moves_writer"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "moves_writer.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+//!
+//! \brief Written write sequences to file by buffered writer and read them
+//! back
+//!
+std::string Written (const std::list <moves_sequence_t> & moves,
+                     size_t buffer_size)
+{
+    const char * filename = TEMP_FILE("moves_writer.txt");
+    std::remove(filename);
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    BOOST_REQUIRE(fd >= 0);
+    {
+        MovesWriter writer (fd, buffer_size);
+        BOOST_CHECK(writer.Write(moves));
+    }
+    close(fd);
+
+    std::ifstream file (filename);
+    std::ostringstream os;
+    os << file.rdbuf();
+    return os.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( same_output )
+{
+    GameTable t (sample);
+    t.CalculateMoves();
+    BOOST_REQUIRE(!t.GetMoves().empty());
+    std::ostringstream os;
+    t.PrintMoves(os);
+
+    std::list <moves_sequence_t> moves = t.GetMoves();
+    moves.push_back(moves_sequence_t());
+    moves.push_back(moves_sequence_t(100, Direction::East));
+    moves.push_back({Direction::North, Direction::West, Direction::South});
+    std::ostringstream expected;
+    for (auto & sequence : moves)
+    {
+        expected << sequence << "\n";
+    }
+    BOOST_CHECK(expected.str().find(os.str()) == 0);
+
+    // long sequences don't fit to small buffers
+    for (size_t buffer_size : {0, 1, 2, 3, 7, 64, 4096})
+    {
+        BOOST_CHECK_EQUAL(Written(moves, buffer_size), expected.str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( table_and_graph )
+{
+    GameTable t (sample);
+    t.CalculateMoves();
+    std::ostringstream expected;
+    t.PrintMoves(expected);
+
+    int fds[2];
+    BOOST_REQUIRE(pipe(fds) == 0);
+    {
+        MovesWriter writer (fds[1], 5);
+        BOOST_CHECK(t.WriteMoves(writer));
+        BOOST_CHECK(writer.Write(t.GetSolutionGraph()));
+        BOOST_CHECK(writer.Flush());
+    }
+    close(fds[1]);
+
+    std::string written;
+    char buffer[256];
+    ssize_t size;
+    while ((size = read(fds[0], buffer, sizeof(buffer))) > 0)
+    {
+        written.append(buffer, size);
+    }
+    close(fds[0]);
+    BOOST_CHECK_EQUAL(written, expected.str() + expected.str());
+}
+
+BOOST_AUTO_TEST_CASE( write_error )
+{
+    MovesWriter writer (-1, 4);
+    BOOST_CHECK(writer.Write(moves_sequence_t(1, Direction::North)));
+    BOOST_CHECK(!writer.Write(moves_sequence_t(1, Direction::South)));
+    // data which can't be written is dropped
+    BOOST_CHECK(writer.Flush());
+}
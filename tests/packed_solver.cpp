@@ -0,0 +1,218 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_packed_solver"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+
+#include "generator.h"
+#include "packed_solver.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+class PackedTable : public GameTable
+{
+public:
+    PackedTable(const input_data_t & data) : GameTable(InputData(data)) {}
+
+    PackedSolver<64> GetSolver () const
+    {
+        std::vector <coordinates_t> starts;
+        for (auto & ball : balls_)
+        {
+            starts.push_back(ball.first);
+        }
+        const move_graph_t & graph = board_->GetMoveGraph();
+        return PackedSolver<64>(RestCells(board_->GetTableSize(), graph, starts),
+                                graph, balls_, board_->GetHoles());
+    }
+};
+
+BOOST_AUTO_TEST_CASE( packed_tilt )
+{
+    // the same game as in table.stacked_balls
+    PackedTable t ({5, 4, 1,
+                    2, 2, 2, 3, 2, 5, 4, 4,
+                    5, 1, 5, 2, 5, 3, 5, 5,
+                    2, 1, 2, 2});
+    PackedSolver<64> solver = t.GetSolver();
+
+    auto cell = [&solver] (coordinate_t x, coordinate_t y) -> std::uint64_t
+    {
+        return solver.Index(coordinates_t(x, y));
+    };
+
+    PackedSolver<64>::state_t state;
+    BOOST_REQUIRE(solver.Tilt(Direction::North, solver.GetStartState(), state));
+    BOOST_CHECK_EQUAL(state, cell(2,2) | cell(2,3) << 8 | cell(2,4) << 16 | cell(4,1) << 24);
+
+    BOOST_REQUIRE(solver.Tilt(Direction::West, solver.GetStartState(), state));
+    BOOST_CHECK_EQUAL(state, cell(1,2) | cell(1,3) << 8 | cell(1,5) << 16 | cell(1,4) << 24);
+
+    // ball 1 falls to the hole of ball 2
+    BOOST_CHECK(!solver.Tilt(Direction::East, solver.GetStartState(), state));
+}
+
+BOOST_AUTO_TEST_CASE( packed_tilt_block )
+{
+    using Solver = PackedSolver<64>;
+
+    GeneratorOptions options;
+    options.seed = 37;
+
+    for (std::uint64_t i = 0; i < 20; ++i)
+    {
+        options.table_size = 4 + i % 5;
+        options.balls_count = 1 + i % 5;
+        options.wall_percent = (i % 3) * 10;
+
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(options, i, puzzle));
+        PackedTable t (puzzle);
+        Solver solver = t.GetSolver();
+
+        // collect some reachable states
+        std::vector <Solver::state_t> states {solver.GetStartState()};
+        for (size_t j = 0; (j < states.size()) && (states.size() < 200); ++j)
+        {
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                Solver::state_t next;
+                if (solver.Tilt(to, states[j], next) &&
+                    (std::find(states.begin(), states.end(), next) == states.end()))
+                {
+                    states.push_back(next);
+                }
+            }
+        }
+
+        for (size_t begin = 0; begin < states.size(); begin += Solver::kLanes)
+        {
+            size_t count = std::min(Solver::kLanes, states.size() - begin);
+            Solver::StateBlock block;
+            Solver::StateBlock tilted;
+            Solver::Unpack(&states[begin], count, block);
+
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                std::uint32_t failures = solver.TiltBlock(to, block, count, tilted);
+                std::array <Solver::state_t, Solver::kLanes> results;
+                Solver::Pack(tilted, count, results.data());
+
+                for (size_t lane = 0; lane < count; ++lane)
+                {
+                    Solver::state_t next;
+                    bool ok = solver.Tilt(to, states[begin + lane], next);
+                    BOOST_CHECK_MESSAGE(ok == !(failures & (1u << lane)),
+                                        "game " << i << " state " << begin + lane);
+                    if (ok)
+                    {
+                        BOOST_CHECK_EQUAL(results[lane], next);
+                    }
+                }
+                BOOST_CHECK_EQUAL(failures >> count, 0u);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( packed_sample )
+{
+    GameTable generic (sample);
+    generic.SetSearchMethod(SearchMethod::Generic);
+    generic.CalculateMoves();
+
+    GameTable packed (sample);
+    packed.SetSearchMethod(SearchMethod::Packed);
+    packed.CalculateMoves();
+
+    BOOST_CHECK(packed.GetMoves() == generic.GetMoves());
+
+    // every state is counted once
+    const SearchStats & stats = packed.GetStats();
+    BOOST_CHECK_EQUAL(stats.generated_by_depth.size(), 4);
+    BOOST_CHECK_EQUAL(stats.expanded_by_depth.size(), 3);
+    BOOST_CHECK(stats.GetGenerated() < generic.GetStats().GetGenerated());
+}
+
+BOOST_AUTO_TEST_CASE( packed_unsolvable )
+{
+    // balls can move only south, but then they fall to wrong holes
+    GameTable t (InputData({2, 2, 0,
+                            1, 1, 2, 1,
+                            2, 2, 1, 2}));
+    t.SetSearchMethod(SearchMethod::Packed);
+    t.CalculateMoves();
+    BOOST_CHECK(t.GetMoves().empty());
+    BOOST_CHECK_EQUAL(t.GetStats().GetExpanded(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( packed_stop_on_hole )
+{
+    // ball stops on its hole right after passing hole of other ball
+    GameTable generic (InputData({3, 3, 0,
+                                  1, 1, 1, 3, 2, 2,
+                                  3, 3, 3, 2, 2, 3}));
+    generic.SetSearchMethod(SearchMethod::Generic);
+    generic.CalculateMoves();
+
+    GameTable packed (InputData({3, 3, 0,
+                                 1, 1, 1, 3, 2, 2,
+                                 3, 3, 3, 2, 2, 3}));
+    packed.SetSearchMethod(SearchMethod::Packed);
+    packed.CalculateMoves();
+
+    BOOST_REQUIRE(!generic.GetMoves().empty());
+    BOOST_CHECK(packed.GetMoves() == generic.GetMoves());
+}
+
+BOOST_AUTO_TEST_CASE( packed_random_games )
+{
+    GeneratorOptions options;
+    options.seed = 36;
+
+    for (std::uint64_t i = 0; i < 60; ++i)
+    {
+        options.table_size = 3 + (i * 7) % 18;
+        options.balls_count = 1 + i % 4;
+        options.wall_percent = (i % 3) * 10;
+
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(options, i, puzzle));
+
+        GameTable generic (InputData{puzzle});
+        generic.SetSearchMethod(SearchMethod::Generic);
+        generic.SetMaxMoves(4);
+        generic.CalculateMoves();
+
+        GameTable packed (InputData{puzzle});
+        packed.SetSearchMethod(SearchMethod::Packed);
+        packed.SetMaxMoves(4);
+        packed.CalculateMoves();
+
+        // the same search without visited states bitmap
+        GameTable unranked (InputData{puzzle});
+        unranked.SetSearchMethod(SearchMethod::Packed);
+        unranked.SetVisitedMemoryLimit(0);
+        unranked.SetMaxMoves(4);
+        unranked.CalculateMoves();
+
+        BOOST_CHECK_MESSAGE(packed.GetMoves() == generic.GetMoves(),
+                            "game " << i);
+        BOOST_CHECK_MESSAGE(unranked.GetMoves() == generic.GetMoves(),
+                            "game " << i);
+        BOOST_CHECK_EQUAL(unranked.GetStats().visited_bytes, 0);
+        if ((options.table_size <= 8) && (packed.GetStats().GetExpanded() != 0))
+        {
+            // small boards are always solved by packed search with bitmap,
+            // unless the game is known to be unsolvable before search
+            BOOST_CHECK(packed.GetStats().visited_bytes > 0);
+            BOOST_CHECK(packed.GetStats().generated_by_depth ==
+                        unranked.GetStats().generated_by_depth);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_rest_cells"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "rest_cells.h"
+#include "table.h"
+#include "tg_utils.h"
+
+class RestTable : public GameTable
+{
+public:
+    RestTable(const input_data_t & data) : GameTable(InputData(data)) {}
+
+    RestCells GetRestCells () const
+    {
+        std::vector <coordinates_t> starts;
+        for (auto & ball : balls_)
+        {
+            starts.push_back(ball.first);
+        }
+        return RestCells(board_->GetTableSize(), board_->GetMoveGraph(), starts);
+    }
+};
+
+BOOST_AUTO_TEST_CASE( single_ball )
+{
+    // single ball goes from the center to the corners and never stops
+    // in the middle of the border
+    RestTable t ({4, 1, 0,
+                  2, 2,
+                  4, 4});
+    RestCells rest = t.GetRestCells();
+
+    std::vector <coordinates_t> expected {{1,1}, {2,1}, {4,1}, {1,2}, {2,2},
+                                          {4,2}, {1,4}, {2,4}, {4,4}};
+    BOOST_REQUIRE_EQUAL(rest.GetCount(), expected.size());
+    for (std::uint32_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(rest.GetIndex(expected[i]), i);
+        BOOST_CHECK(rest.GetCell(i) == expected[i]);
+    }
+
+    BOOST_CHECK_EQUAL(rest.GetIndex(coordinates_t(3, 1)), RestCells::kInvalidIndex);
+    BOOST_CHECK_EQUAL(rest.GetIndex(coordinates_t(3, 3)), RestCells::kInvalidIndex);
+    BOOST_CHECK_EQUAL(rest.GetIndex(coordinates_t(0, 1)), RestCells::kInvalidIndex);
+    BOOST_CHECK_EQUAL(rest.GetIndex(coordinates_t(5, 1)), RestCells::kInvalidIndex);
+}
+
+BOOST_AUTO_TEST_CASE( stacked_balls )
+{
+    // second ball can stop right behind the first one
+    RestTable t ({4, 2, 0,
+                  2, 2, 3, 3,
+                  4, 4, 1, 4});
+    RestCells rest = t.GetRestCells();
+
+    BOOST_CHECK(rest.GetIndex(coordinates_t(3, 1)) != RestCells::kInvalidIndex);
+    BOOST_CHECK(rest.GetIndex(coordinates_t(1, 3)) != RestCells::kInvalidIndex);
+    for (std::uint32_t i = 0; i < rest.GetCount(); ++i)
+    {
+        BOOST_CHECK_EQUAL(rest.GetIndex(rest.GetCell(i)), i);
+    }
+}
@@ -0,0 +1,192 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solution_cache"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+#include "solution_cache.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+const std::list <moves_sequence_t> sample_solutions =
+{
+    {Direction::North, Direction::West, Direction::East},
+    {Direction::North, Direction::East, Direction::West},
+    {Direction::West,  Direction::North, Direction::East},
+    {Direction::East,  Direction::North, Direction::West}
+};
+
+BOOST_AUTO_TEST_CASE( store_and_lookup )
+{
+    const char * filename = TEMP_FILE("cache_store.bin");
+    std::remove(filename);
+
+    SolutionCache cache (filename);
+    BOOST_REQUIRE(cache.IsOpen());
+
+    std::list <moves_sequence_t> solutions;
+    BOOST_CHECK_EQUAL(cache.Lookup(sample, solutions), false);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+
+    BOOST_CHECK_EQUAL(cache.Store(sample, sample_solutions), true);
+    BOOST_CHECK_EQUAL(cache.Store(sample_too_long, {}), true);
+    BOOST_CHECK_EQUAL(cache.GetRecordsCount(), 2);
+
+    BOOST_CHECK_EQUAL(cache.Lookup(sample, solutions), true);
+    BOOST_CHECK(solutions == sample_solutions);
+
+    BOOST_CHECK_EQUAL(cache.Lookup(sample_too_long, solutions), true);
+    BOOST_CHECK(solutions.empty());
+
+    BOOST_CHECK_EQUAL(cache.GetHits(), 2);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( persistence )
+{
+    const char * filename = TEMP_FILE("cache_persistence.bin");
+    std::remove(filename);
+
+    {
+        SolutionCache cache (filename);
+        BOOST_REQUIRE(cache.IsOpen());
+        BOOST_CHECK_EQUAL(cache.Store(sample, sample_solutions), true);
+    }
+
+    SolutionCache cache (filename);
+    BOOST_REQUIRE(cache.IsOpen());
+    BOOST_CHECK_EQUAL(cache.GetRecordsCount(), 1);
+
+    std::list <moves_sequence_t> solutions;
+    BOOST_CHECK_EQUAL(cache.Lookup(sample, solutions), true);
+    BOOST_CHECK(solutions == sample_solutions);
+}
+
+BOOST_AUTO_TEST_CASE( eviction )
+{
+    const char * filename = TEMP_FILE("cache_eviction.bin");
+    std::remove(filename);
+
+    SolutionCache cache (filename, 1024);
+    BOOST_REQUIRE(cache.IsOpen());
+
+    input_data_t key = sample;
+    for (coordinate_t i = 0; i < 100; ++i)
+    {
+        key[0] = i;
+        BOOST_CHECK_EQUAL(cache.Store(key, sample_solutions), true);
+        BOOST_CHECK(cache.GetDataSize() <= 1024);
+    }
+    BOOST_CHECK(cache.GetEvictions() > 0);
+
+    // Newest record survives, the oldest one is evicted
+    std::list <moves_sequence_t> solutions;
+    BOOST_CHECK_EQUAL(cache.Lookup(key, solutions), true);
+    key[0] = 0;
+    BOOST_CHECK_EQUAL(cache.Lookup(key, solutions), false);
+}
+
+BOOST_AUTO_TEST_CASE( shared_file )
+{
+    const char * filename = TEMP_FILE("cache_shared.bin");
+    std::remove(filename);
+
+    SolutionCache first (filename, 1024);
+    SolutionCache second (filename, 1024);
+    BOOST_REQUIRE(first.IsOpen());
+    BOOST_REQUIRE(second.IsOpen());
+
+    // Records appended by one instance are visible to the other
+    input_data_t key = sample;
+    std::list <moves_sequence_t> solutions;
+    BOOST_CHECK_EQUAL(first.Store(key, sample_solutions), true);
+    BOOST_CHECK_EQUAL(second.Lookup(key, solutions), true);
+    BOOST_CHECK(solutions == sample_solutions);
+
+    // Both instances append and evict, records are never overwritten
+    for (coordinate_t i = 1; i < 100; ++i)
+    {
+        key[0] = i;
+        SolutionCache & writer = (i % 2) ? second : first;
+        SolutionCache & reader = (i % 2) ? first : second;
+        BOOST_CHECK_EQUAL(writer.Store(key, sample_solutions), true);
+
+        solutions.clear();
+        BOOST_CHECK_EQUAL(reader.Lookup(key, solutions), true);
+        BOOST_CHECK(solutions == sample_solutions);
+        BOOST_CHECK(reader.GetDataSize() <= 1024);
+    }
+    BOOST_CHECK(first.GetEvictions() > 0);
+    BOOST_CHECK(second.GetEvictions() > 0);
+
+    // Evicted by one instance, so missed by the other
+    key[0] = 0;
+    BOOST_CHECK_EQUAL(second.Lookup(key, solutions), false);
+    BOOST_CHECK_EQUAL(first.Lookup(key, solutions), false);
+    BOOST_CHECK_EQUAL(first.GetRecordsCount(), second.GetRecordsCount());
+
+    // File reopened after interleaved access is consistent
+    SolutionCache third (filename, 1024);
+    BOOST_REQUIRE(third.IsOpen());
+    BOOST_CHECK_EQUAL(third.GetRecordsCount(), first.GetRecordsCount());
+    key[0] = 99;
+    BOOST_CHECK_EQUAL(third.Lookup(key, solutions), true);
+    BOOST_CHECK(solutions == sample_solutions);
+}
+
+BOOST_AUTO_TEST_CASE( cached_table )
+{
+    const char * filename = TEMP_FILE("cache_table.bin");
+    std::remove(filename);
+
+    SolutionCache cache (filename);
+    BOOST_REQUIRE(cache.IsOpen());
+
+    GameTable solved (sample);
+    solved.SetSolutionCache(&cache);
+    solved.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+
+    // Walls described in other order and direction is the same puzzle
+    input_data_t same = { SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT, SAMPLE_WALLS_COUNT,
+                          SAMPLE_BALL_1, SAMPLE_BALL_2,
+                          SAMPLE_HOLE_1, SAMPLE_HOLE_2,
+                          4,2,3,2, 1,3,1,2 };
+    GameTable cached ((InputData(same)));
+    BOOST_CHECK(cached.GetPuzzleKey() == solved.GetPuzzleKey());
+
+    cached.SetSolutionCache(&cache);
+    cached.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetHits(), 1);
+
+    auto expected = solved.GetMoves();
+    auto moves = cached.GetMoves();
+    BOOST_CHECK(moves == expected);
+    BOOST_CHECK(cached.GetStats().from_cache);
+    BOOST_CHECK_EQUAL(cached.GetStats().GetExpanded(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( damaged_record )
+{
+    const char * filename = TEMP_FILE("cache_damaged.bin");
+    std::remove(filename);
+
+    SolutionCache cache (filename);
+    BOOST_REQUIRE(cache.IsOpen());
+
+    // Sequences of different length can't be the best moves of the game
+    GameTable t (sample);
+    const std::list <moves_sequence_t> damaged =
+    {
+        {Direction::North},
+        {Direction::North, Direction::West, Direction::East}
+    };
+    BOOST_REQUIRE(cache.Store(t.GetPuzzleKey(), damaged));
+
+    t.SetSolutionCache(&cache);
+    t.CalculateMoves();
+    BOOST_CHECK(t.GetStats().from_cache);
+    BOOST_CHECK(t.GetSolutionGraph().IsEmpty());
+}
@@ -0,0 +1,170 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solution_graph"
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <sstream>
+
+#include "generator.h"
+#include "solution_graph.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+using Edge = SolutionGraph::Edge;
+
+//!
+//! \brief Printed gives printed form of the graph
+//!
+std::string Printed (const SolutionGraph & graph)
+{
+    std::ostringstream os;
+    graph.Print(os);
+    return os.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( empty_graph )
+{
+    SolutionGraph graph;
+    BOOST_CHECK(graph.IsEmpty());
+    BOOST_CHECK_EQUAL(graph.GetStatesCount(), 0);
+    BOOST_CHECK_EQUAL(graph.GetSequencesCount(), 0);
+    BOOST_CHECK(graph.Expand().empty());
+    BOOST_CHECK(Printed(graph).empty());
+
+    // won without moves: single empty sequence
+    graph.Assign({});
+    BOOST_CHECK(!graph.IsEmpty());
+    BOOST_CHECK_EQUAL(graph.GetStatesCount(), 1);
+    BOOST_CHECK_EQUAL(graph.GetSequencesCount(), 1);
+    BOOST_REQUIRE_EQUAL(graph.Expand().size(), 1);
+    BOOST_CHECK(graph.Expand().front().empty());
+}
+
+BOOST_AUTO_TEST_CASE( diamond_graph )
+{
+    // two ways to the same middle state, then two ways to the win
+    std::vector <std::vector <Edge> > layers (2);
+    layers[0] = {{0, Direction::East, 1}, {0, Direction::North, 1},
+                 {0, Direction::West, 0}, {0, Direction::North, 1}};
+    layers[1] = {{1, Direction::South, 0}, {0, Direction::West, 0},
+                 {1, Direction::North, 0}};
+    SolutionGraph graph;
+    graph.Assign(std::move(layers));
+
+    BOOST_CHECK_EQUAL(graph.GetDepth(), 2);
+    BOOST_CHECK_EQUAL(graph.GetStatesCount(), 4);
+    BOOST_CHECK_EQUAL(graph.GetMovesCount(), 6);
+    BOOST_CHECK_EQUAL(graph.GetSequencesCount(), 5);
+
+    std::list <moves_sequence_t> expected = {
+        {Direction::North, Direction::North}, {Direction::North, Direction::South},
+        {Direction::West, Direction::West},
+        {Direction::East, Direction::North}, {Direction::East, Direction::South}};
+    BOOST_CHECK(graph.Expand() == expected);
+
+    SolutionGraph::Iterator iterator (graph);
+    moves_sequence_t moves;
+    for (auto & sequence : expected)
+    {
+        BOOST_REQUIRE(iterator.Next(moves));
+        BOOST_CHECK(moves == sequence);
+    }
+    BOOST_CHECK(!iterator.Next(moves));
+    BOOST_CHECK(!iterator.Next(moves));
+
+    // states are numbered by the first move reaching them
+    BOOST_CHECK_EQUAL(Printed(graph), "2 4 5\n"
+                                      "0 N 1 W 2 E 1\n"
+                                      "1 N 3 S 3\n"
+                                      "2 W 3\n");
+}
+
+BOOST_AUTO_TEST_CASE( sequences_overflow )
+{
+    // every move doubles number of sequences
+    std::vector <std::vector <Edge> > layers (70);
+    for (auto & layer : layers)
+    {
+        layer = {{0, Direction::North, 0}, {0, Direction::South, 0}};
+    }
+    SolutionGraph graph;
+    graph.Assign(std::move(layers));
+    BOOST_CHECK_EQUAL(graph.GetStatesCount(), 71);
+    BOOST_CHECK_EQUAL(graph.GetSequencesCount(),
+                      std::numeric_limits<std::uint64_t>::max());
+
+    moves_sequence_t moves;
+    SolutionGraph::Iterator iterator (graph);
+    BOOST_REQUIRE(iterator.Next(moves));
+    BOOST_CHECK(moves == moves_sequence_t(70, Direction::North));
+    BOOST_REQUIRE(iterator.Next(moves));
+    BOOST_CHECK(moves.back() == Direction::South);
+}
+
+BOOST_AUTO_TEST_CASE( table_graph )
+{
+    GeneratorOptions generator;
+    generator.seed = 49;
+    generator.table_size = 7;
+    generator.balls_count = 2;
+    generator.wall_percent = 10;
+
+    size_t solved = 0;
+    for (std::uint64_t i = 0; i < 20; ++i)
+    {
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(generator, i, puzzle));
+
+        // generic search lists sequences, graph is built from them
+        GameTable generic ((InputData(puzzle)));
+        generic.SetSearchMethod(SearchMethod::Generic);
+        generic.CalculateMoves();
+
+        // packed search finds the graph itself
+        GameTable packed ((InputData(puzzle)));
+        packed.SetSearchMethod(SearchMethod::Packed);
+        packed.SetExpandMoves(false);
+        packed.CalculateMoves();
+
+        const SolutionGraph & graph = packed.GetSolutionGraph();
+        BOOST_CHECK_MESSAGE(graph.Expand() == generic.GetMoves(), "game " << i);
+        BOOST_CHECK_EQUAL(graph.GetSequencesCount(), generic.GetMoves().size());
+        BOOST_CHECK_MESSAGE(Printed(graph) == Printed(generic.GetSolutionGraph()),
+                            "game " << i);
+        if (!generic.GetMoves().empty())
+        {
+            ++solved;
+            BOOST_REQUIRE_EQUAL(packed.GetMoves().size(), 1);
+            BOOST_CHECK(packed.GetMoves().front() == generic.GetMoves().front());
+        }
+    }
+    BOOST_CHECK(solved > 0);
+}
+
+BOOST_AUTO_TEST_CASE( edited_table_graph )
+{
+    GameTable t (sample);
+    t.SetSearchMethod(SearchMethod::Generic);
+    t.CalculateMoves();
+    std::list <moves_sequence_t> moves = t.GetMoves();
+    BOOST_REQUIRE(!moves.empty());
+
+    // graph describes found moves, not the edited game
+    BOOST_CHECK(t.AddWall(wall_coordinates_t(1,1, 1,2)));
+    BOOST_CHECK(t.MoveBall(1, coordinates_t(3,3)));
+    BOOST_CHECK(t.GetSolutionGraph().Expand() == moves);
+
+    // next search describes the edited game, original one is restored
+    BOOST_CHECK(t.RemoveWall(wall_coordinates_t(1,1, 1,2)));
+    BOOST_CHECK(t.MoveBall(1, coordinates_t(SAMPLE_BALL_1)));
+    t.CalculateMoves();
+    BOOST_CHECK(t.GetMoves() == moves);
+    BOOST_CHECK(t.GetSolutionGraph().Expand() == moves);
+}
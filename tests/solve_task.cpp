@@ -0,0 +1,116 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solve_task"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "generator.h"
+#include "solve_task.h"
+#include "table.h"
+#include "tests_config.h"
+
+namespace
+{
+
+//!
+//! \brief SlowGame gives big game, which is solved for a long time
+//!
+input_data_t SlowGame ()
+{
+    GeneratorOptions options;
+    options.seed = 48;
+    options.table_size = 32;
+    options.balls_count = 6;
+    options.wall_percent = 10;
+
+    input_data_t puzzle;
+    BOOST_REQUIRE(GeneratePuzzle(options, 0, puzzle));
+    return puzzle;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( async_moves )
+{
+    GameTable exact (sample);
+    exact.CalculateMoves();
+
+    GameTable t (sample);
+    size_t calls = 0;
+    bool cancelled = true;
+    SolveTask task (t, [&calls, &cancelled] (const GameTable & table)
+    {
+        // checked in test thread, assertions are not thread safe
+        cancelled = table.GetStats().cancelled;
+        ++calls;
+    });
+    SolveTask::future_t future = task.GetFuture();
+    BOOST_CHECK(future.get() == exact.GetMoves());
+    BOOST_CHECK(task.IsDone());
+    BOOST_CHECK_EQUAL(calls, 1);
+    BOOST_CHECK(!cancelled);
+
+    BOOST_CHECK(t.GetMoves() == exact.GetMoves());
+    BOOST_CHECK_EQUAL(task.GetExpanded(), t.GetStats().GetExpanded());
+    BOOST_CHECK_EQUAL(task.GetDepth() + 1, exact.GetMoves().front().size());
+}
+
+BOOST_AUTO_TEST_CASE( async_cancel )
+{
+    GameTable t (SlowGame());
+    t.SetSearchMethod(SearchMethod::Generic);
+    bool cancelled = false;
+    SolveTask task (t, [&cancelled] (const GameTable & table)
+    {
+        cancelled = table.GetStats().cancelled;
+    });
+
+    while (task.GetExpanded() == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_CHECK(!task.IsDone());
+
+    task.Cancel();
+    BOOST_REQUIRE(task.GetFuture().wait_for(std::chrono::seconds(10)) ==
+                  std::future_status::ready);
+    BOOST_CHECK(task.GetFuture().get().empty());
+    BOOST_CHECK(cancelled);
+    BOOST_CHECK(t.GetStats().cancelled);
+
+    // table is usable again and keeps no flag of finished task
+    t.SetMaxMoves(1);
+    t.CalculateMoves();
+    BOOST_CHECK(!t.GetStats().cancelled);
+}
+
+BOOST_AUTO_TEST_CASE( async_error )
+{
+    GameTable t (sample);
+    SolveTask task (t, [] (const GameTable &)
+    {
+        throw std::runtime_error("callback failed");
+    });
+
+    task.Wait();
+    BOOST_CHECK(task.IsDone());
+    BOOST_CHECK_THROW(task.GetFuture().get(), std::runtime_error);
+
+    // table keeps no flag of failed task
+    t.CalculateMoves();
+    BOOST_CHECK(!t.GetStats().cancelled);
+    BOOST_CHECK(!t.GetMoves().empty());
+}
+
+BOOST_AUTO_TEST_CASE( async_destroy )
+{
+    GameTable t (SlowGame());
+    {
+        SolveTask task (t);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK(t.GetStats().cancelled || !t.GetMoves().empty());
+}
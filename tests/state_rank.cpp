@@ -0,0 +1,62 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_state_rank"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "state_rank.h"
+
+BOOST_AUTO_TEST_CASE( state_ranker )
+{
+    StateRanker ranker (16, 3);
+    BOOST_CHECK_EQUAL(ranker.GetSpaceSize(), 17 * 17 * 17);
+    BOOST_CHECK_EQUAL(ranker.GetRemovedCell(), 16);
+
+    std::vector <std::uint32_t> cells {0, 0, 0};
+    BOOST_CHECK_EQUAL(ranker.Rank(cells), 0);
+    cells = {16, 16, 16};
+    BOOST_CHECK_EQUAL(ranker.Rank(cells), ranker.GetSpaceSize() - 1);
+
+    // every rank is unique and describes some state
+    std::vector <std::uint32_t> state;
+    for (std::uint64_t rank = 0; rank < ranker.GetSpaceSize(); ++rank)
+    {
+        ranker.Unrank(rank, state);
+        BOOST_REQUIRE_EQUAL(state.size(), 3);
+        BOOST_REQUIRE_EQUAL(ranker.Rank(state), rank);
+    }
+
+    // space doesn't fit to 64 bits
+    BOOST_CHECK_EQUAL(StateRanker(576, 7).GetSpaceSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( visited_states )
+{
+    VisitedStates visited;
+    BOOST_CHECK(!visited.IsEnabled());
+    BOOST_CHECK(!visited.Reset(0, 1, 1024));
+    BOOST_CHECK(!visited.Reset(1 << 20, 2, 1024));
+    BOOST_CHECK(!visited.IsEnabled());
+
+    BOOST_REQUIRE(visited.Reset(1000, 2, 1024));
+    BOOST_CHECK(visited.IsEnabled());
+    BOOST_CHECK_EQUAL(visited.GetBytes(), 16 * 8 * 2);
+
+    BOOST_CHECK(visited.Visit(5));
+    BOOST_CHECK(!visited.Visit(5));
+    BOOST_CHECK(visited.IsVisited(5));
+
+    // states of next depth are visited only after it is generated
+    visited.VisitNext(999);
+    visited.VisitNext(999);
+    BOOST_CHECK(!visited.IsVisited(999));
+    visited.NextDepth();
+    BOOST_CHECK(visited.IsVisited(999));
+    BOOST_CHECK(!visited.IsVisited(998));
+
+    // reset drops everything
+    BOOST_REQUIRE(visited.Reset(1000, 1, 1024));
+    BOOST_CHECK(!visited.IsVisited(5));
+    BOOST_CHECK(!visited.IsVisited(999));
+}
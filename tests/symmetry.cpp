@@ -0,0 +1,89 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_symmetry"
+
+#include <boost/test/unit_test.hpp>
+
+#include "symmetry.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+BOOST_AUTO_TEST_CASE( inverse )
+{
+    for (unsigned i = 0; i < kSymmetriesCount; ++i)
+    {
+        Symmetry s = static_cast<Symmetry>(i);
+        for (coordinate_t x = 1; x <= SAMPLE_TABLE_SIZE; ++x)
+        {
+            for (coordinate_t y = 1; y <= SAMPLE_TABLE_SIZE; ++y)
+            {
+                coordinates_t c (x, y);
+                coordinates_t t = Transform(c, s, SAMPLE_TABLE_SIZE);
+                BOOST_CHECK(IsValid(t, SAMPLE_TABLE_SIZE));
+                BOOST_CHECK_EQUAL(Transform(t, Inverse(s), SAMPLE_TABLE_SIZE), c);
+            }
+        }
+        for (auto d : {Direction::North, Direction::West,
+                       Direction::South, Direction::East})
+        {
+            BOOST_CHECK_EQUAL(Transform(Transform(d, s), Inverse(s)), d);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( directions )
+{
+    BOOST_CHECK_EQUAL(Transform(Direction::North, Symmetry::Rotate90), Direction::East);
+    BOOST_CHECK_EQUAL(Transform(Direction::North, Symmetry::Rotate270), Direction::West);
+    BOOST_CHECK_EQUAL(Transform(Direction::West, Symmetry::FlipHorizontal), Direction::East);
+    BOOST_CHECK_EQUAL(Transform(Direction::West, Symmetry::FlipVertical), Direction::West);
+    BOOST_CHECK_EQUAL(Transform(Direction::South, Symmetry::Transpose), Direction::East);
+    BOOST_CHECK_EQUAL(Transform(Direction::South, Symmetry::AntiTranspose), Direction::West);
+}
+
+BOOST_AUTO_TEST_CASE( normalised_key )
+{
+    GameTable t (sample);
+    input_data_t key = t.GetPuzzleKey();
+
+    BOOST_CHECK(NormalisePuzzleKey(sample) == key);
+    BOOST_CHECK(NormalisePuzzleKey(key) == key);
+    BOOST_CHECK(Transform(key, Symmetry::Identity) == key);
+}
+
+BOOST_AUTO_TEST_CASE( canonical_form )
+{
+    CanonicalPuzzle canonical = Canonicalise(sample);
+    BOOST_CHECK(Transform(sample, canonical.symmetry) == canonical.key);
+
+    for (unsigned i = 0; i < kSymmetriesCount; ++i)
+    {
+        Symmetry s = static_cast<Symmetry>(i);
+        BOOST_CHECK(Canonicalise(Transform(sample, s)).key == canonical.key);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( transformed_solutions )
+{
+    GameTable t (sample);
+    t.CalculateMoves();
+    std::list <moves_sequence_t> moves = t.GetMoves();
+    BOOST_REQUIRE(!moves.empty());
+
+    for (unsigned i = 0; i < kSymmetriesCount; ++i)
+    {
+        Symmetry s = static_cast<Symmetry>(i);
+
+        GameTable transformed ((InputData(Transform(sample, s))));
+        transformed.CalculateMoves();
+
+        std::list <moves_sequence_t> expected;
+        for (auto & sequence : moves)
+        {
+            expected.push_back(Transform(sequence, s));
+        }
+        SortMoves(expected);
+
+        BOOST_CHECK(transformed.GetMoves() == expected);
+    }
+}
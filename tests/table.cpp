@@ -3,6 +3,10 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdio>
+#include <sstream>
+
+#include "generator.h"
 #include "table.h"
 #include "tests_config.h"
 #include "tg_utils.h"
@@ -21,149 +25,151 @@ public:
 
     void CkeckMoveGraph()
     {
+        const move_graph_t & graph = board_->GetMoveGraph();
+
         // First check connections between cells
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetNeigbour(Direction::North),
                           coordinates_t(1,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetNeigbour(Direction::West),
                           coordinates_t(1,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetNeigbour(Direction::South),
                           coordinates_t(1,2));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetNeigbour(Direction::East),
                           coordinates_t(4,1));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetNeigbour(Direction::North),
                           coordinates_t(2,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetNeigbour(Direction::West),
                           coordinates_t(1,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetNeigbour(Direction::South),
                           coordinates_t(2,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetNeigbour(Direction::East),
                           coordinates_t(4,1));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetNeigbour(Direction::North),
                           coordinates_t(3,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetNeigbour(Direction::West),
                           coordinates_t(1,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetNeigbour(Direction::South),
                           coordinates_t(3,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetNeigbour(Direction::East),
                           coordinates_t(4,1));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetNeigbour(Direction::North),
                           coordinates_t(4,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetNeigbour(Direction::West),
                           coordinates_t(1,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetNeigbour(Direction::South),
                           coordinates_t(4,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetNeigbour(Direction::East),
                           coordinates_t(4,1));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetNeigbour(Direction::North),
                           coordinates_t(1,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetNeigbour(Direction::West),
                           coordinates_t(1,2));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetNeigbour(Direction::South),
                           coordinates_t(1,2));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetNeigbour(Direction::East),
                           coordinates_t(3,2));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetNeigbour(Direction::North),
                           coordinates_t(2,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetNeigbour(Direction::West),
                           coordinates_t(1,2));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetNeigbour(Direction::South),
                           coordinates_t(2,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetNeigbour(Direction::East),
                           coordinates_t(3,2));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetNeigbour(Direction::North),
                           coordinates_t(3,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetNeigbour(Direction::West),
                           coordinates_t(1,2));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetNeigbour(Direction::South),
                           coordinates_t(3,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetNeigbour(Direction::East),
                           coordinates_t(3,2));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetNeigbour(Direction::North),
                           coordinates_t(4,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetNeigbour(Direction::West),
                           coordinates_t(4,2));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetNeigbour(Direction::South),
                           coordinates_t(4,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetNeigbour(Direction::East),
                           coordinates_t(4,2));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetNeigbour(Direction::North),
                           coordinates_t(1,3));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetNeigbour(Direction::West),
                           coordinates_t(1,3));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetNeigbour(Direction::South),
                           coordinates_t(1,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetNeigbour(Direction::East),
                           coordinates_t(4,3));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetNeigbour(Direction::North),
                           coordinates_t(2,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetNeigbour(Direction::West),
                           coordinates_t(1,3));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetNeigbour(Direction::South),
                           coordinates_t(2,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetNeigbour(Direction::East),
                           coordinates_t(4,3));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetNeigbour(Direction::North),
                           coordinates_t(3,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetNeigbour(Direction::West),
                           coordinates_t(1,3));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetNeigbour(Direction::South),
                           coordinates_t(3,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetNeigbour(Direction::East),
                           coordinates_t(4,3));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetNeigbour(Direction::North),
                           coordinates_t(4,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetNeigbour(Direction::West),
                           coordinates_t(1,3));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetNeigbour(Direction::South),
                           coordinates_t(4,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetNeigbour(Direction::East),
                           coordinates_t(4,3));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetNeigbour(Direction::North),
                           coordinates_t(1,3));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetNeigbour(Direction::West),
                           coordinates_t(1,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetNeigbour(Direction::South),
                           coordinates_t(1,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetNeigbour(Direction::East),
                           coordinates_t(4,4));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetNeigbour(Direction::North),
                           coordinates_t(2,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetNeigbour(Direction::West),
                           coordinates_t(1,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetNeigbour(Direction::South),
                           coordinates_t(2,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetNeigbour(Direction::East),
                           coordinates_t(4,4));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetNeigbour(Direction::North),
                           coordinates_t(3,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetNeigbour(Direction::West),
                           coordinates_t(1,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetNeigbour(Direction::South),
                           coordinates_t(3,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetNeigbour(Direction::East),
                           coordinates_t(4,4));
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetNeigbour(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetNeigbour(Direction::North),
                           coordinates_t(4,1));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetNeigbour(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetNeigbour(Direction::West),
                           coordinates_t(1,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetNeigbour(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetNeigbour(Direction::South),
                           coordinates_t(4,4));
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetNeigbour(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetNeigbour(Direction::East),
                           coordinates_t(4,4));
 
         // then check connected holes
@@ -173,149 +179,175 @@ public:
 
 
         // First check connections between cells
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,1)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::West),
                           hole_1);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,1)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::West),
                           hole_1);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,1)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::West),
                           hole_1);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::South),
                           hole_2);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::North),
                           hole_1);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,2)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,2)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,2)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::South),
                           hole_2);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,2)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,3)).GetHolesOnWayTo(Direction::East),
                           hole_2);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,3)).GetHolesOnWayTo(Direction::East),
                           hole_2);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,3)).GetHolesOnWayTo(Direction::East),
                           hole_2);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,3)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(1,4)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(2,4)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::North),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::West),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::West),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::South),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::South),
                           null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::East),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(3,4)).GetHolesOnWayTo(Direction::East),
                           null_vector);
 
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::North),
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::North),
                           hole_2);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::West),
-                          null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::South),
-                          null_vector);
-        BOOST_CHECK_EQUAL(move_graph_.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::East),
-                          null_vector);
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::West),
+                          null_vector);
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::South),
+                          null_vector);
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,4)).GetHolesOnWayTo(Direction::East),
+                          null_vector);
+
+        // hole masks must describe the same holes in the same order
+        for (auto & item : graph)
+        {
+            for (auto to : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+            {
+                const GraphItem & gi = item.second;
+                auto & cells = gi.GetHolesOnWayTo(to);
+                auto & ids = gi.GetHoleIdsOnWayTo(to);
+                BOOST_REQUIRE_EQUAL(cells.size(), ids.size());
+
+                hole_mask_t mask = 0;
+                for (size_t i = 0; i < ids.size(); ++i)
+                {
+                    BOOST_CHECK_EQUAL(board_->GetCells().at(cells[i]).HoleId(),
+                                      ids[i]);
+                    mask |= HoleBit(ids[i]);
+                }
+                BOOST_CHECK_EQUAL(gi.GetHoleMask(to), mask);
+            }
+        }
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetHoleMask(Direction::West),
+                          HoleBit(1));
+        BOOST_CHECK_EQUAL(graph.at(coordinates_t(4,1)).GetHoleMask(Direction::South),
+                          HoleBit(2));
     }
 
 
@@ -327,3 +359,466 @@ BOOST_AUTO_TEST_CASE( check_table )
     t.CalculateMoves();
     t.CkeckMoveGraph();
 }
+
+BOOST_AUTO_TEST_CASE( first_open_hole )
+{
+    GraphItem gi;
+    gi.AddHole(Direction::East, coordinates_t(2,1), 3);
+    gi.AddHole(Direction::East, coordinates_t(3,1), 1);
+    gi.AddHole(Direction::East, coordinates_t(4,1), 2);
+
+    BOOST_CHECK_EQUAL(gi.GetHoleMask(Direction::East), 7);
+    BOOST_CHECK_EQUAL(gi.GetHoleMask(Direction::West), 0);
+
+    BOOST_CHECK_EQUAL(gi.FirstOpenHole(Direction::East, 7), 3);
+    BOOST_CHECK_EQUAL(gi.FirstOpenHole(Direction::East, 3), 1);
+    BOOST_CHECK_EQUAL(gi.FirstOpenHole(Direction::East, 2), 2);
+    BOOST_CHECK_EQUAL(gi.FirstOpenHole(Direction::East, 8), INVALID_ID);
+    BOOST_CHECK_EQUAL(gi.FirstOpenHole(Direction::West, 7), INVALID_ID);
+}
+
+BOOST_AUTO_TEST_CASE( search_stats )
+{
+    GameTable t (sample);
+    t.SetSearchMethod(SearchMethod::Generic);
+    t.CalculateMoves();
+
+    const SearchStats & stats = t.GetStats();
+    BOOST_CHECK_EQUAL(stats.from_cache, false);
+    BOOST_REQUIRE(!stats.generated_by_depth.empty());
+    BOOST_CHECK_EQUAL(stats.generated_by_depth[0], 1);
+    BOOST_CHECK_EQUAL(stats.expanded_by_depth[0], 1);
+    BOOST_CHECK(stats.GetExpanded() < stats.GetGenerated());
+    BOOST_CHECK(stats.peak_frontier > 0);
+    BOOST_CHECK(stats.peak_bytes_in_use > 0);
+
+    // best moves are 3 moves long: search stops after expanding the layer
+    // of 3-move states, so generation ends one level deeper, at 4 moves
+    BOOST_CHECK_EQUAL(stats.generated_by_depth.size(), 5);
+    BOOST_CHECK_EQUAL(stats.expanded_by_depth.size(), 4);
+
+    std::ostringstream os;
+    os << stats;
+    BOOST_CHECK(os.str().find("generated_by_depth=1,4,") != std::string::npos);
+    BOOST_CHECK(os.str().find('\n') == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( tilt_cache )
+{
+    GameTable cached (sample);
+    cached.SetSearchMethod(SearchMethod::Generic);
+    cached.CalculateMoves();
+
+    GameTable uncached (sample);
+    uncached.SetSearchMethod(SearchMethod::Generic);
+    uncached.SetTiltCacheSize(0);
+    uncached.CalculateMoves();
+
+    BOOST_CHECK(cached.GetMoves() == uncached.GetMoves());
+    BOOST_CHECK_EQUAL(cached.GetStats().GetGenerated(),
+                      uncached.GetStats().GetGenerated());
+
+    const SearchStats & stats = cached.GetStats();
+    BOOST_CHECK(stats.tilt_cache_hits > 0);
+    BOOST_CHECK(stats.GetTiltCacheHitRate() > 0);
+    BOOST_CHECK_EQUAL(stats.tilt_cache_hits + stats.tilt_cache_misses,
+                      stats.GetExpanded() * 4);
+    BOOST_CHECK_EQUAL(uncached.GetStats().tilt_cache_hits, 0);
+
+    // single slot: results keep replacing each other, but stay correct
+    GameTable tiny (sample);
+    tiny.SetSearchMethod(SearchMethod::Generic);
+    tiny.SetTiltCacheSize(1);
+    tiny.CalculateMoves();
+    BOOST_CHECK(tiny.GetMoves() == uncached.GetMoves());
+}
+
+BOOST_AUTO_TEST_CASE( visited_states )
+{
+    GameTable ranked (sample);
+    ranked.SetSearchMethod(SearchMethod::Generic);
+    ranked.CalculateMoves();
+
+    GameTable unranked (sample);
+    unranked.SetSearchMethod(SearchMethod::Generic);
+    unranked.SetVisitedMemoryLimit(0);
+    unranked.CalculateMoves();
+
+    BOOST_CHECK(ranked.GetMoves() == unranked.GetMoves());
+    BOOST_CHECK(ranked.GetStats().visited_bytes > 0);
+    BOOST_CHECK(ranked.GetStats().visited_rejections > 0);
+    BOOST_CHECK(ranked.GetStats().GetGenerated() < unranked.GetStats().GetGenerated());
+    BOOST_CHECK_EQUAL(unranked.GetStats().visited_bytes, 0);
+    BOOST_CHECK_EQUAL(unranked.GetStats().visited_rejections, 0);
+}
+
+class RollTable : public GameTable
+{
+public:
+    RollTable(const input_data_t & data) : GameTable(InputData(data)) {}
+
+    positions_t Roll (Direction to)
+    {
+        positions_t balls;
+        positions_t holes;
+        for (auto & ball : balls_)
+        {
+            balls.insert(std::make_pair(ball.first, ball.second.GetId()));
+        }
+        for (auto & hole : board_->GetHoles())
+        {
+            holes.insert(std::make_pair(hole.second, hole.first));
+        }
+
+        positions_t new_position;
+        positions_t removed;
+        BOOST_REQUIRE(RollAllBalls(to, balls, holes, new_position, removed));
+        BOOST_CHECK(removed.empty());
+        return new_position;
+    }
+};
+
+BOOST_AUTO_TEST_CASE( stacked_balls )
+{
+    // three balls in column 2, wall between (2,1) and (2,2);
+    // one more ball in row 4, holes are out of the way
+    RollTable t ({5, 4, 1,
+                  2, 2, 2, 3, 2, 5, 4, 4,
+                  5, 1, 5, 2, 5, 3, 5, 5,
+                  2, 1, 2, 2});
+
+    positions_t north = t.Roll(Direction::North);
+    positions_t expected_north {{coordinates_t(2,2), 1}, {coordinates_t(2,3), 2},
+                                {coordinates_t(2,4), 3}, {coordinates_t(4,1), 4}};
+    BOOST_CHECK(north == expected_north);
+
+    positions_t south = t.Roll(Direction::South);
+    positions_t expected_south {{coordinates_t(2,3), 1}, {coordinates_t(2,4), 2},
+                                {coordinates_t(2,5), 3}, {coordinates_t(4,5), 4}};
+    BOOST_CHECK(south == expected_south);
+
+    positions_t west = t.Roll(Direction::West);
+    positions_t expected_west {{coordinates_t(1,2), 1}, {coordinates_t(1,3), 2},
+                               {coordinates_t(1,5), 3}, {coordinates_t(1,4), 4}};
+    BOOST_CHECK(west == expected_west);
+}
+
+BOOST_AUTO_TEST_CASE( ball_takes_left_cell )
+{
+    // after East balls stand at (4,2) and (4,3). Tilting South ball 1
+    // takes (4,3) just left by ball 2. Balls roll at once, so the tilt is
+    // valid whatever order the balls are placed in
+    input_data_t game = {4, 2, 3,
+                         4, 2, 2, 3,
+                         1, 3, 3, 4,
+                         1, 2, 2, 2, 2, 2, 2, 3, 1, 4, 2, 4};
+    const std::list <moves_sequence_t> expected =
+    {
+        {Direction::East, Direction::South, Direction::West}
+    };
+
+    for (auto method : {SearchMethod::Generic, SearchMethod::Packed,
+                        SearchMethod::Deepening})
+    {
+        GameTable t ((InputData(game)));
+        t.SetSearchMethod(method);
+        t.CalculateMoves();
+        BOOST_CHECK_MESSAGE(t.GetMoves() == expected, method);
+    }
+}
+
+//!
+//! \brief SameGraphs check if move graphs are the same
+//!
+bool SameGraphs (const move_graph_t & a, const move_graph_t & b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (auto & item : a)
+    {
+        const GraphItem & other = b.at(item.first);
+        for (auto to : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+        {
+            if ((item.second.GetNeigbour(to) != other.GetNeigbour(to)) ||
+                (item.second.GetHolesOnWayTo(to) != other.GetHolesOnWayTo(to)) ||
+                (item.second.GetHoleIdsOnWayTo(to) != other.GetHoleIdsOnWayTo(to)) ||
+                (item.second.GetHoleMask(to) != other.GetHoleMask(to)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE( edit_table )
+{
+    GameTable t (sample);
+    input_data_t key = t.GetPuzzleKey();
+
+    BOOST_CHECK(!t.AddWall(wall_coordinates_t(1, 1, 2, 2)));
+    BOOST_CHECK(!t.AddWall(wall_coordinates_t(0, 1, 1, 1)));
+    BOOST_CHECK(!t.RemoveWall(wall_coordinates_t(4, 1, 5, 1)));
+    BOOST_CHECK(!t.MoveBall(3, coordinates_t(3, 3)));
+    BOOST_CHECK(!t.MoveHole(3, coordinates_t(3, 3)));
+    BOOST_CHECK(!t.MoveBall(1, coordinates_t(SAMPLE_HOLE_1)));
+    BOOST_CHECK(!t.MoveBall(1, coordinates_t(SAMPLE_BALL_2)));
+    BOOST_CHECK(!t.MoveHole(1, coordinates_t(SAMPLE_BALL_2)));
+    BOOST_CHECK(!t.MoveHole(1, coordinates_t(SAMPLE_HOLE_2)));
+    BOOST_CHECK(t.GetPuzzleKey() == key);
+
+    BOOST_CHECK(t.AddWall(wall_coordinates_t(2, 1, 1, 1)));
+    BOOST_CHECK_EQUAL(t.GetPuzzleKey()[2], SAMPLE_WALLS_COUNT + 1);
+    BOOST_CHECK(t.RemoveWall(wall_coordinates_t(1, 1, 2, 1)));
+    BOOST_CHECK(t.GetPuzzleKey() == key);
+
+    BOOST_CHECK(t.MoveBall(1, coordinates_t(3, 3)));
+    BOOST_CHECK(t.MoveHole(2, coordinates_t(4, 4)));
+    key[3] = 3;
+    key[4] = 3;
+    key[9] = 4;
+    key[10] = 4;
+    BOOST_CHECK(t.GetPuzzleKey() == key);
+}
+
+BOOST_AUTO_TEST_CASE( edited_random_games )
+{
+    GeneratorOptions options;
+    options.seed = 44;
+    options.table_size = 6;
+    options.balls_count = 2;
+    options.wall_percent = 15;
+
+    input_data_t puzzle;
+    BOOST_REQUIRE(GeneratePuzzle(options, 0, puzzle));
+    GameTable edited ((InputData(puzzle)));
+    edited.SetMaxMoves(8);
+    edited.CalculateMoves();
+
+    // every edit is checked against the game built from scratch
+    std::uint64_t random = 44;
+    for (size_t i = 0; i < 60; ++i)
+    {
+        random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+        coordinate_t x = 1 + (random >> 33) % 6;
+        coordinate_t y = 1 + (random >> 41) % 6;
+        coordinates_t cell (x, y);
+        coordinates_t next = ((random >> 50) & 1) ? coordinates_t(x + 1, y)
+                                                  : coordinates_t(x, y + 1);
+        ball_id_t id = 1 + (random >> 55) % 2;
+        switch (i % 4)
+        {
+        case 0:
+            edited.AddWall(wall_coordinates_t(cell, next));
+            break;
+        case 1:
+            edited.RemoveWall(wall_coordinates_t(cell, next));
+            break;
+        case 2:
+            edited.MoveBall(id, cell);
+            break;
+        case 3:
+            edited.MoveHole(id, cell);
+            break;
+        }
+        edited.CalculateMoves();
+
+        GameTable fresh ((InputData(edited.GetPuzzleKey())));
+        fresh.SetMaxMoves(8);
+        fresh.CalculateMoves();
+
+        BOOST_CHECK_MESSAGE(edited.GetMoves() == fresh.GetMoves(), "edit " << i);
+        BOOST_CHECK_MESSAGE(SameGraphs(edited.GetMoveGraph(), fresh.GetMoveGraph()),
+                            "edit " << i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( warm_bound )
+{
+    GameTable t (sample);
+    t.SetSearchMethod(SearchMethod::Generic);
+    t.CalculateMoves();
+    BOOST_CHECK_EQUAL(t.GetStats().warm_bound, 0);
+    std::list <moves_sequence_t> moves = t.GetMoves();
+    BOOST_REQUIRE(!moves.empty());
+    size_t generated = t.GetStats().GetGenerated();
+
+    // the same game: previous best solution limits the search
+    t.CalculateMoves();
+    BOOST_CHECK_EQUAL(t.GetStats().warm_bound, moves.front().size());
+    BOOST_CHECK(t.GetMoves() == moves);
+    BOOST_CHECK(t.GetStats().GetGenerated() <= generated);
+}
+
+BOOST_AUTO_TEST_CASE( approximate_moves )
+{
+    GameTable exact (sample);
+    exact.CalculateMoves();
+    BOOST_CHECK(exact.IsOptimal());
+    BOOST_REQUIRE(!exact.GetMoves().empty());
+
+    // beam wider than number of states is the same as full search
+    BeamOptions options;
+    options.width = 1000;
+    options.rollouts = 3;
+    for (unsigned threads : {1u, 3u})
+    {
+        options.threads = threads;
+        GameTable t (sample);
+        t.CalculateApproximateMoves(options);
+        BOOST_CHECK(!t.IsOptimal());
+        BOOST_CHECK(t.GetStats().approximate);
+        BOOST_CHECK_EQUAL(t.GetStats().rollouts, 3);
+        BOOST_REQUIRE_EQUAL(t.GetMoves().size(), 1);
+        BOOST_CHECK(t.GetMoves().front() == exact.GetMoves().front());
+    }
+
+    // unsolvable game is not searched
+    GameTable walled (InputData({3,1,4, 2,2, 1,1, 2,2,1,2, 2,2,3,2,
+                                 2,2,2,1, 2,2,2,3}));
+    walled.CalculateApproximateMoves(options);
+    BOOST_CHECK(walled.GetMoves().empty());
+    BOOST_CHECK_EQUAL(walled.GetStats().unsolvability, Unsolvability::FrozenBall);
+}
+
+BOOST_AUTO_TEST_CASE( approximate_random_games )
+{
+    GeneratorOptions generator;
+    generator.seed = 46;
+    generator.table_size = 8;
+    generator.balls_count = 3;
+    generator.wall_percent = 20;
+
+    BeamOptions options;
+    options.width = 4;
+    options.rollouts = 4;
+    options.threads = 2;
+    for (std::uint64_t i = 0; i < 20; ++i)
+    {
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(generator, i, puzzle));
+        GameTable t ((InputData(puzzle)));
+        t.CalculateApproximateMoves(options);
+        if (t.GetMoves().empty())
+        {
+            continue;
+        }
+
+        // found sequence wins, so the best one is not longer
+        size_t length = t.GetMoves().front().size();
+        GameTable exact ((InputData(puzzle)));
+        exact.SetMaxMoves(length);
+        exact.CalculateMoves();
+        BOOST_REQUIRE_MESSAGE(!exact.GetMoves().empty(), "game " << i);
+        BOOST_CHECK(exact.GetMoves().front().size() <= length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( deepening_random_games )
+{
+    GeneratorOptions generator;
+    generator.seed = 47;
+    generator.table_size = 6;
+    generator.balls_count = 2;
+    generator.wall_percent = 20;
+
+    for (std::uint64_t i = 0; i < 20; ++i)
+    {
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(generator, i, puzzle));
+        GameTable generic ((InputData(puzzle)));
+        generic.SetSearchMethod(SearchMethod::Generic);
+        generic.CalculateMoves();
+
+        GameTable deepening ((InputData(puzzle)));
+        deepening.SetSearchMethod(SearchMethod::Deepening);
+        deepening.CalculateMoves();
+        BOOST_CHECK_MESSAGE(generic.GetMoves() == deepening.GetMoves(), "game " << i);
+
+        // loops are broken without transposition table too
+        GameTable untracked ((InputData(puzzle)));
+        untracked.SetSearchMethod(SearchMethod::Deepening);
+        untracked.SetVisitedMemoryLimit(0);
+        untracked.SetMaxMoves(8);
+        untracked.CalculateMoves();
+        if (!generic.GetMoves().empty() && (generic.GetMoves().front().size() <= 8))
+        {
+            BOOST_CHECK_MESSAGE(generic.GetMoves() == untracked.GetMoves(), "game " << i);
+        }
+        else
+        {
+            BOOST_CHECK_MESSAGE(untracked.GetMoves().empty(), "game " << i);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( portfolio_search )
+{
+    GameTable exact (sample);
+    exact.CalculateMoves();
+    BOOST_CHECK(exact.GetStats().winner == SearchMethod::Auto);
+
+    GameTable t (sample);
+    t.SetSearchMethod(SearchMethod::Portfolio);
+    t.CalculateMoves();
+    BOOST_CHECK(t.GetMoves() == exact.GetMoves());
+    BOOST_CHECK(!t.GetStats().cancelled);
+    BOOST_CHECK(t.GetStats().winner != SearchMethod::Auto);
+
+    std::ostringstream os;
+    os << t.GetStats();
+    BOOST_CHECK(os.str().find(" winner=") != std::string::npos);
+
+    GeneratorOptions generator;
+    generator.seed = 47;
+    generator.table_size = 8;
+    generator.balls_count = 3;
+    generator.wall_percent = 20;
+    for (std::uint64_t i = 0; i < 10; ++i)
+    {
+        input_data_t puzzle;
+        BOOST_REQUIRE(GeneratePuzzle(generator, i, puzzle));
+        GameTable generic ((InputData(puzzle)));
+        generic.SetSearchMethod(SearchMethod::Generic);
+        generic.CalculateMoves();
+
+        GameTable portfolio ((InputData(puzzle)));
+        portfolio.SetSearchMethod(SearchMethod::Portfolio);
+        portfolio.CalculateMoves();
+        BOOST_CHECK_MESSAGE(generic.GetMoves() == portfolio.GetMoves(), "game " << i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( cancelled_search )
+{
+    std::atomic <bool> cancel (true);
+    for (auto method : {SearchMethod::Generic, SearchMethod::Packed,
+                        SearchMethod::Deepening, SearchMethod::Portfolio})
+    {
+        GameTable t (sample);
+        t.SetSearchMethod(method);
+        t.SetCancelFlag(&cancel);
+        t.CalculateMoves();
+        BOOST_CHECK_MESSAGE(t.GetMoves().empty(), method);
+        BOOST_CHECK_MESSAGE(t.GetStats().cancelled, method);
+    }
+
+    // cancelled search doesn't spoil the cache
+    const char * filename = TEMP_FILE("cache_cancelled.bin");
+    std::remove(filename);
+
+    SolutionCache cache (filename);
+    GameTable t (sample);
+    t.SetSolutionCache(&cache);
+    t.SetCancelFlag(&cancel);
+    t.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetRecordsCount(), 0);
+
+    cancel = false;
+    t.CalculateMoves();
+    BOOST_CHECK(!t.GetMoves().empty());
+    BOOST_CHECK_EQUAL(cache.GetRecordsCount(), 1);
+}